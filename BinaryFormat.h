@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+
+/*
+ * File: BinaryFormat.h
+ * --------------------
+ * Small helpers shared by the binary files written by the program
+ * (items snapshots, compiled rule caches).
+ *
+ * All of them use the same conventions: a fixed header followed by
+ * sections in native byte order, each padded to 8 bytes so that the
+ * mapped file can be read in place; offset columns have count + 1
+ * entries, start at 0 and end at the size of the section they index.
+ */
+
+// Written into every header; a mismatch means a foreign byte order
+const uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+/*
+ * Function: padded
+ * ----------------
+ * Rounds a section size up to the 8-byte section alignment.
+ */
+inline uint64_t padded(uint64_t bytes) {
+    return (bytes + 7) & ~uint64_t(7);
+}
+
+/*
+ * Function: write_section
+ * -----------------------
+ * Writes one section followed by zero padding up to the alignment.
+ */
+inline void write_section(std::ostream& out, const void* data, uint64_t bytes) {
+    static const char zeros[8] = {};
+    if (bytes > 0)
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    out.write(zeros, static_cast<std::streamsize>(padded(bytes) - bytes));
+}
+
+/*
+ * Function: offsets_valid
+ * -----------------------
+ * Checks that an offset column starts at 0, never decreases and ends
+ * at total.
+ */
+inline bool offsets_valid(const uint64_t* offsets, uint64_t count, uint64_t total) {
+    if (offsets[0] != 0 || offsets[count] != total) return false;
+    for (uint64_t i = 0; i < count; i++)
+        if (offsets[i] > offsets[i + 1]) return false;
+    return true;
+}
+
+/*
+ * Function: content_hash
+ * ----------------------
+ * 64-bit hash of a byte range, used to tell whether a source file has
+ * changed since a binary file was derived from it. Reads 8 bytes per
+ * step; not suitable for anything security related.
+ */
+inline uint64_t content_hash(std::string_view data) {
+    const uint64_t k = 0x9E3779B97F4A7C15ULL;
+    uint64_t h = 0xCBF29CE484222325ULL ^ (data.size() * k);
+    size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data.data() + i, 8);
+        h = (h ^ w) * k;
+        h ^= h >> 29;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data.data() + i, data.size() - i);
+    h = (h ^ tail) * k;
+    h ^= h >> 32;
+    return h;
+}
@@ -1,5 +1,9 @@
 #include "Classifier.h"
 #include "Matching.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
 
 /*
  * Function: classify
@@ -14,10 +18,432 @@ classify(const std::vector<Record>& records, const std::vector<ClassRule>& class
     for (const auto& c : classRules) {
         for (const auto& r : records) {
             if (match_all_rules(r, c)) {
-                result[c.className].push_back(r.name);
+                result[c.className].emplace_back(r.name);
             }
         }
     }
 
     return result;
 }
+
+/*
+ * Function: classify
+ * ------------------
+ * Same loop order as classify on records: classes outer, records inner.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const std::vector<ClassRule>& classRules) {
+    std::map<std::string, std::vector<std::string>> result;
+
+    for (const auto& c : classRules) {
+        for (size_t r = 0; r < store.size(); r++) {
+            if (match_all_rules(store, r, c)) {
+                result[c.className].emplace_back(store.name(r));
+            }
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Function: tune_tiling
+ * ---------------------
+ * Sizes are estimates: a class costs its rule ids and one Rule per rule,
+ * a record its share of the values, presence bits and offsets, and its
+ * memo.
+ */
+ClassifyTiling tune_tiling(const RecordStore& store, const RuleTable& table,
+    size_t cacheBytes, ClassifyTiling requested, size_t threads) {
+    const size_t half = std::max<size_t>(cacheBytes / 2, 1);
+
+    if (requested.classes == 0) {
+        const size_t classes = std::max<size_t>(table.classCount(), 1);
+        const size_t classBytes = sizeof(uint32_t)
+            + table.instanceCount() * (sizeof(uint32_t) + sizeof(Rule)) / classes;
+        requested.classes = std::max<size_t>(1, half / classBytes);
+    }
+    if (requested.records == 0) {
+        const size_t records = std::max<size_t>(store.size(), 1);
+        const size_t memoBytes = 2 * sizeof(uint64_t) * ((table.ruleCount() + 63) / 64);
+        const size_t recordBytes = memoBytes + (store.valueBytes() + store.indexBytes()) / records;
+        requested.records = std::clamp(half / recordBytes, MIN_TILE_RECORDS, MAX_TILE_RECORDS);
+
+        const size_t blocks = BLOCKS_PER_THREAD * std::max<size_t>(threads, 1);
+        if (threads > 1)
+            requested.records = std::max<size_t>(1, std::min(requested.records, (records + blocks - 1) / blocks));
+    }
+    return requested;
+}
+
+/*
+ * Function: classify_block
+ * ------------------------
+ * Checks the records [first, last) against all classes, one block of
+ * classes at a time, calling emit(class, record) for each match. For
+ * every class, records are emitted in ascending order. memos holds one
+ * memo per record of the block: a record meets the rules of every class
+ * block before the block is done.
+ */
+template <class Emit>
+static void classify_block(const RecordStore& store, const RuleTable& table, size_t first,
+    size_t last, size_t classBlock, std::vector<RuleMemo>& memos, Emit emit) {
+    for (size_t r = first; r < last; r++)
+        memos[r - first].reset(table.ruleCount());
+
+    for (size_t c0 = 0; c0 < table.classCount(); c0 += classBlock) {
+        const size_t c1 = std::min(c0 + classBlock, table.classCount());
+        for (size_t r = first; r < last; r++) {
+            for (size_t c = c0; c < c1; c++) {
+                if (match_class(store, r, table, c, memos[r - first]))
+                    emit(c, r);
+            }
+        }
+    }
+}
+
+/*
+ * Function: classify
+ * ------------------
+ * Record blocks outer, then the tiles of the block (see classify_block).
+ * Matches are collected per class in record order, then merged by class
+ * name as classify does.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const RuleTable& table,
+    const std::vector<ClassRule>& classRules, ClassifyTiling tiling) {
+    std::vector<std::vector<std::string>> matches(classRules.size());
+    tiling = tune_tiling(store, table, cpu_features().l2Cache, tiling);
+    std::vector<RuleMemo> memos(std::min(tiling.records, std::max<size_t>(store.size(), 1)));
+
+    for (size_t first = 0; first < store.size(); first += tiling.records) {
+        classify_block(store, table, first, std::min(first + tiling.records, store.size()),
+            tiling.classes, memos, [&](size_t c, size_t r) { matches[c].emplace_back(store.name(r)); });
+    }
+
+    return collect_class_matches(classRules, matches);
+}
+
+/*
+ * Function: classify
+ * ------------------
+ * Each record block is one iteration of a parallel loop. A block writes
+ * its matches as (class, record) pairs into its own slot, and the slots
+ * are replayed in block order afterwards, which appends the records of
+ * every class in ascending order exactly as the sequential loop does.
+ * Memos belong to the thread running a block.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const RuleTable& table,
+    const std::vector<ClassRule>& classRules, ThreadPool& pool, ClassifyTiling tiling) {
+    tiling = tune_tiling(store, table, cpu_features().l2Cache, tiling, pool.size());
+    const size_t blockCount = (store.size() + tiling.records - 1) / tiling.records;
+    const size_t memoCount = std::min(tiling.records, std::max<size_t>(store.size(), 1));
+
+    // Step 1: Match the blocks in parallel
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> hits(blockCount);
+    std::vector<std::vector<RuleMemo>> memos(pool.size());
+    pool.parallelFor(blockCount, [&](size_t block, size_t thread) {
+        if (memos[thread].empty()) memos[thread].resize(memoCount);
+        const size_t first = block * tiling.records;
+        classify_block(store, table, first, std::min(first + tiling.records, store.size()),
+            tiling.classes, memos[thread], [&](size_t c, size_t r) {
+                hits[block].emplace_back(static_cast<uint32_t>(c), static_cast<uint32_t>(r));
+            });
+    });
+
+    // Step 2: Replay the matches in block order
+    std::vector<std::vector<std::string>> matches(classRules.size());
+    for (auto& block : hits) {
+        for (const auto& [c, r] : block)
+            matches[c].emplace_back(store.name(r));
+        std::vector<std::pair<uint32_t, uint32_t>>().swap(block);
+    }
+
+    return collect_class_matches(classRules, matches);
+}
+
+/*
+ * Function: rule_postings
+ * -----------------------
+ * Records that can satisfy a rule: all of them must have the property,
+ * and for CONTAINS_VALUE they must contain the value. EQUALS_EXACTLY
+ * starts from the presence list too, so an index built for the rules
+ * needs no value lists for it.
+ */
+static PostingView rule_postings(const InvertedIndex& index, const Rule& rule) {
+    if (rule.type == CONTAINS_VALUE)
+        return index.withValue(rule.propertyId, rule.expectedValue);
+    return index.withProperty(rule.propertyId);
+}
+
+/*
+ * Function: classify
+ * ------------------
+ * Runs the pooled version below on the calling thread alone.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules) {
+    ThreadPool pool(1);
+    return classify(store, index, classRules, pool);
+}
+
+/*
+ * Function: classify
+ * ------------------
+ * Per class: posting lists of all rules, intersected from the shortest
+ * up, then the rules the lists only approximate are checked on the
+ * surviving records. Each class is one iteration of a parallel loop and
+ * keeps its records in its own slot, in ascending record order, which
+ * is the order classify on the store reports them in; the names are
+ * added in class order afterwards.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules, ThreadPool& pool) {
+    std::vector<PostingList> members(classRules.size());
+    std::vector<std::vector<PostingView>> lists(pool.size());
+
+    pool.parallelFor(classRules.size(), [&](size_t i, size_t thread) {
+        const ClassRule& c = classRules[i];
+        PostingList& candidates = members[i];
+
+        // Step 1: Candidates (a class without rules matches every record)
+        std::vector<PostingView>& own = lists[thread];
+        own.clear();
+        for (const auto& rule : c.rules)
+            own.push_back(rule_postings(index, rule));
+        std::sort(own.begin(), own.end(),
+            [](const PostingView& a, const PostingView& b) { return a.size() < b.size(); });
+
+        if (own.empty()) {
+            for (size_t r = 0; r < store.size(); r++)
+                candidates.push_back(static_cast<uint32_t>(r));
+        }
+        else {
+            candidates.assign(own[0].begin(), own[0].end());
+            for (size_t k = 1; k < own.size() && !candidates.empty(); k++)
+                intersect_postings(candidates, own[k]);
+        }
+
+        // Step 2: Rules not answered exactly by their list
+        auto rejected = [&](uint32_t r) {
+            for (const Rule& rule : c.rules) {
+                if ((rule.type == PROPERTY_SIZE || rule.type == EQUALS_EXACTLY) && !match_rule(store, r, rule))
+                    return true;
+            }
+            return false;
+        };
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), rejected), candidates.end());
+    });
+
+    // Step 3: Names, in class order
+    std::map<std::string, std::vector<std::string>> result;
+    for (size_t i = 0; i < classRules.size(); i++) {
+        if (members[i].empty()) continue;
+        auto& names = result[classRules[i].className];
+        for (uint32_t r : members[i])
+            names.emplace_back(store.name(r));
+        PostingList().swap(members[i]);
+    }
+
+    return result;
+}
+
+/*
+ * Function: rule_bitmap
+ * ---------------------
+ * Records satisfying one rule: the posting list itself for the rules it
+ * answers exactly, otherwise the posting list filtered by the rule.
+ */
+static RecordBitmap rule_bitmap(const RecordStore& store, const InvertedIndex& index, const Rule& rule) {
+    PostingView candidates = rule_postings(index, rule);
+    if (rule.type == HAS_PROPERTY || rule.type == CONTAINS_VALUE)
+        return RecordBitmap::fromSorted(candidates.data, candidates.count);
+
+    RecordBitmap bitmap;
+    for (uint32_t r : candidates)
+        if (match_rule(store, r, rule))
+            bitmap.add(r);
+    return bitmap;
+}
+
+/*
+ * Function: class_bitmaps
+ * -----------------------
+ * Runs the pooled version below on the calling thread alone.
+ */
+std::vector<RecordBitmap> class_bitmaps(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules) {
+    ThreadPool pool(1);
+    return class_bitmaps(store, index, classRules, pool);
+}
+
+/*
+ * Function: class_bitmaps
+ * -----------------------
+ * Distinct rules are numbered by rule identity first; then one parallel
+ * loop evaluates their bitmaps and a second one builds the classes,
+ * each starting from its smallest rule bitmap and ANDing in the others.
+ * Every iteration writes only its own slot.
+ */
+std::vector<RecordBitmap> class_bitmaps(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules, ThreadPool& pool) {
+    // Step 1: Rule ids of every class
+    std::unordered_map<Rule, uint32_t, RuleHash, RuleEqual> ids;
+    std::vector<const Rule*> rules;
+    std::vector<std::vector<uint32_t>> classIds(classRules.size());
+    for (size_t c = 0; c < classRules.size(); c++) {
+        for (const auto& rule : classRules[c].rules) {
+            auto [it, added] = ids.emplace(rule, static_cast<uint32_t>(rules.size()));
+            if (added) rules.push_back(&rule);
+            classIds[c].push_back(it->second);
+        }
+    }
+
+    // Step 2: One bitmap per distinct rule
+    std::vector<RecordBitmap> ruleBitmaps(rules.size());
+    pool.parallelFor(rules.size(), [&](size_t i, size_t) {
+        ruleBitmaps[i] = rule_bitmap(store, index, *rules[i]);
+    });
+
+    // Step 3: One AND per class
+    std::vector<RecordBitmap> classes(classRules.size());
+    pool.parallelFor(classRules.size(), [&](size_t c, size_t) {
+        std::vector<uint32_t>& own = classIds[c];
+        if (own.empty()) {
+            classes[c] = RecordBitmap::range(static_cast<uint32_t>(store.size()));
+            return;
+        }
+        std::sort(own.begin(), own.end(), [&](uint32_t a, uint32_t b) {
+            return ruleBitmaps[a].cardinality() < ruleBitmaps[b].cardinality();
+        });
+        RecordBitmap members = ruleBitmaps[own[0]];
+        for (size_t i = 1; i < own.size() && !members.empty(); i++)
+            members &= ruleBitmaps[own[i]];
+        classes[c] = std::move(members);
+    });
+
+    return classes;
+}
+
+/*
+ * Function: classify_bitmaps
+ * --------------------------
+ * Runs the pooled version below on the calling thread alone.
+ */
+std::map<std::string, std::vector<std::string>>
+classify_bitmaps(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules) {
+    ThreadPool pool(1);
+    return classify_bitmaps(store, index, classRules, pool);
+}
+
+/*
+ * Function: classify_bitmaps
+ * --------------------------
+ * Appends the names of each class's records in bitmap (= record) order;
+ * classes sharing a name are concatenated in class order.
+ */
+std::map<std::string, std::vector<std::string>>
+classify_bitmaps(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules, ThreadPool& pool) {
+    std::map<std::string, std::vector<std::string>> result;
+    std::vector<RecordBitmap> members = class_bitmaps(store, index, classRules, pool);
+
+    for (size_t i = 0; i < classRules.size(); i++) {
+        if (members[i].empty()) continue;
+        auto& names = result[classRules[i].className];
+        names.reserve(names.size() + members[i].cardinality());
+        members[i].forEach([&](uint32_t r) { names.emplace_back(store.name(r)); });
+    }
+
+    return result;
+}
+
+/*
+ * Function: classify_record
+ * -------------------------
+ * Checks one record against all classes, in class order.
+ */
+void classify_record(const Record& record, const std::vector<ClassRule>& classRules,
+    std::vector<std::vector<std::string>>& matches) {
+    for (size_t i = 0; i < classRules.size(); i++) {
+        if (match_all_rules(record, classRules[i])) {
+            matches[i].emplace_back(record.name);
+        }
+    }
+}
+
+/*
+ * Function: classify_record
+ * -------------------------
+ * Checks one record against all classes of a rule table, in class order.
+ */
+void classify_record(const Record& record, const RuleTable& table,
+    std::vector<std::vector<std::string>>& matches, RuleMemo& memo) {
+    memo.reset(table.ruleCount());
+    for (size_t c = 0; c < table.classCount(); c++) {
+        if (match_class(record, table, c, memo))
+            matches[c].emplace_back(record.name);
+    }
+}
+
+/*
+ * Function: collect_class_matches
+ * -------------------------------
+ * Moves the per-class lists into a class-name map, producing the same
+ * result as classify for the same records.
+ */
+std::map<std::string, std::vector<std::string>>
+collect_class_matches(const std::vector<ClassRule>& classRules,
+    std::vector<std::vector<std::string>>& matches) {
+    std::map<std::string, std::vector<std::string>> result;
+
+    for (size_t i = 0; i < classRules.size(); i++) {
+        if (matches[i].empty()) continue;
+
+        auto& names = result[classRules[i].className];
+        if (names.empty())
+            names = std::move(matches[i]);
+        else
+            names.insert(names.end(), std::make_move_iterator(matches[i].begin()),
+                std::make_move_iterator(matches[i].end()));
+    }
+
+    return result;
+}
+
+/*
+ * Function: classify_snapshot
+ * ---------------------------
+ * Same loop order as classify: classes outer, records inner. Rules are
+ * looked up by their interned (lowercase) name, as the snapshot stores
+ * it; a rule on a property name that no record has never matches.
+ */
+std::map<std::string, std::vector<std::string>>
+classify_snapshot(const RecordSnapshot& snapshot, const std::vector<ClassRule>& classRules) {
+    std::map<std::string, std::vector<std::string>> result;
+
+    for (const auto& c : classRules) {
+        // Resolve property names of this class once
+        std::vector<int> ids;
+        for (const auto& rule : c.rules)
+            ids.push_back(snapshot.findName(property_name(rule.propertyId)));
+
+        for (size_t r = 0; r < snapshot.size(); r++) {
+            bool matched = true;
+            for (size_t i = 0; i < c.rules.size() && matched; i++) {
+                const int* values = nullptr;
+                size_t count = 0;
+                matched = snapshot.findProperty(r, ids[i], values, count) &&
+                    match_values(c.rules[i], values, count);
+            }
+            if (matched)
+                result[c.className].emplace_back(snapshot.name(r));
+        }
+    }
+
+    return result;
+}
@@ -4,6 +4,12 @@
 #include <vector>
 #include "Record.h"
 #include "Rule.h"
+#include "RecordSnapshot.h"
+#include "RecordStore.h"
+#include "InvertedIndex.h"
+#include "RecordBitmap.h"
+#include "RuleTable.h"
+#include "ThreadPool.h"
 
 /*
  * Function: classify
@@ -21,3 +27,185 @@
  */
 std::map<std::string, std::vector<std::string>>
 classify(const std::vector<Record>& records, const std::vector<ClassRule>& classRules);
+
+/*
+ * Function: classify
+ * ------------------
+ * Classifies the records of a columnar store. The result is identical
+ * to classify() on the records the store was built from.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const std::vector<ClassRule>& classRules);
+
+/*
+ * Structure: ClassifyTiling
+ * -------------------------
+ * Block sizes of the tiled classification loop: the records of one
+ * block are checked against one block of classes before moving on to
+ * the next class block, so both stay in cache while they are combined.
+ *
+ * Fields:
+ *   - records : records per block (0 = choose with tune_tiling).
+ *   - classes : classes per block (0 = choose with tune_tiling).
+ */
+struct ClassifyTiling {
+    size_t records = 0;
+    size_t classes = 0;
+};
+
+// Bounds of the automatically chosen number of records per block
+const size_t MIN_TILE_RECORDS = 64;
+const size_t MAX_TILE_RECORDS = 65536;
+
+// Record blocks per thread that the parallel classify aims for at least
+const size_t BLOCKS_PER_THREAD = 4;
+
+/*
+ * Function: tune_tiling
+ * ---------------------
+ * Picks the block sizes that are 0 in requested so that a block of
+ * classes (their rule ids and rules) fills about half of a cache of
+ * cacheBytes, and a block of records (their column data and rule
+ * memos) the other half. When all classes fit in one block, records
+ * are simply checked one after the other. With several threads, record
+ * blocks are made small enough that each thread gets a few of them.
+ */
+ClassifyTiling tune_tiling(const RecordStore& store, const RuleTable& table,
+    size_t cacheBytes, ClassifyTiling requested = {}, size_t threads = 1);
+
+/*
+ * Function: classify
+ * ------------------
+ * Classifies the records of a columnar store with the rules compiled
+ * into a table (built from classRules), in tiles of records x classes
+ * (see ClassifyTiling; by default sized to the L2 cache). Each record
+ * keeps its rule memo across the class blocks, so each distinct rule is
+ * still evaluated at most once per record. The result is identical to
+ * classify() on the store, whatever the block sizes.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const RuleTable& table,
+    const std::vector<ClassRule>& classRules, ClassifyTiling tiling = {});
+
+/*
+ * Function: classify
+ * ------------------
+ * Same as the tiled classify above, with the record blocks spread over
+ * the threads of a pool (work stealing balances blocks whose records
+ * match very differently). The result, including the order of the
+ * names of each class, is identical to the sequential classify.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const RuleTable& table,
+    const std::vector<ClassRule>& classRules, ThreadPool& pool, ClassifyTiling tiling = {});
+
+/*
+ * Function: classify
+ * ------------------
+ * Classifies the records of a columnar store through its inverted index.
+ * The candidates of a class are the intersection of the posting lists
+ * of its rules, shortest first; only rules the lists do not answer
+ * exactly (PROPERTY_SIZE, EQUALS_EXACTLY) are checked per candidate.
+ * The result is identical to classify() on the store.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules);
+
+/*
+ * Function: classify
+ * ------------------
+ * Same as the index classify above, with the classes spread over the
+ * threads of a pool. The result is identical to the sequential one.
+ */
+std::map<std::string, std::vector<std::string>>
+classify(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules, ThreadPool& pool);
+
+/*
+ * Function: class_bitmaps
+ * -----------------------
+ * Evaluates every distinct rule (see same_rule) once, over all records,
+ * into a bitmap of the records that satisfy it, and returns for each
+ * class the AND of the bitmaps of its rules (indexed like classRules).
+ * A rule shared by many classes costs one evaluation.
+ */
+std::vector<RecordBitmap> class_bitmaps(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules);
+
+/*
+ * Function: class_bitmaps
+ * -----------------------
+ * Same as above, with the rule bitmaps and then the class ANDs spread
+ * over the threads of a pool.
+ */
+std::vector<RecordBitmap> class_bitmaps(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules, ThreadPool& pool);
+
+/*
+ * Function: classify_bitmaps
+ * --------------------------
+ * Classifies the records of a store through class_bitmaps; the name
+ * lists are produced by iterating the class bitmaps. The result is
+ * identical to classify() on the store.
+ */
+std::map<std::string, std::vector<std::string>>
+classify_bitmaps(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules);
+
+/*
+ * Function: classify_bitmaps
+ * --------------------------
+ * Same as above, with class_bitmaps run on a pool; the name lists are
+ * produced on the calling thread, in class order.
+ */
+std::map<std::string, std::vector<std::string>>
+classify_bitmaps(const RecordStore& store, const InvertedIndex& index,
+    const std::vector<ClassRule>& classRules, ThreadPool& pool);
+
+/*
+ * Function: classify_record
+ * -------------------------
+ * Matches a single record against every class and appends its name to
+ * matches[i] for each class i whose rules it satisfies. Used to classify
+ * records as they are parsed, without keeping them in memory.
+ *
+ * Parameters:
+ *   - record     : record to classify
+ *   - classRules : list of class definitions with rules
+ *   - matches    : per-class lists of matching record names
+ *                  (one entry per class in classRules)
+ */
+void classify_record(const Record& record, const std::vector<ClassRule>& classRules,
+    std::vector<std::vector<std::string>>& matches);
+
+/*
+ * Function: classify_record
+ * -------------------------
+ * Same as above with the classes compiled into a rule table; memo is
+ * scratch space for the rule results of the record, reusable across
+ * calls (one per thread).
+ */
+void classify_record(const Record& record, const RuleTable& table,
+    std::vector<std::vector<std::string>>& matches, RuleMemo& memo);
+
+/*
+ * Function: collect_class_matches
+ * -------------------------------
+ * Converts per-class match lists (indexed like classRules) into the map
+ * returned by classify: only classes with matches get an entry, and
+ * classes sharing a name are concatenated in class order.
+ */
+std::map<std::string, std::vector<std::string>>
+collect_class_matches(const std::vector<ClassRule>& classRules,
+    std::vector<std::vector<std::string>>& matches);
+
+/*
+ * Function: classify_snapshot
+ * ---------------------------
+ * Classifies the records of a loaded snapshot without materializing
+ * them. Rule property names are resolved to snapshot name ids once;
+ * the result is identical to classify() on the original records.
+ */
+std::map<std::string, std::vector<std::string>>
+classify_snapshot(const RecordSnapshot& snapshot, const std::vector<ClassRule>& classRules);
@@ -0,0 +1,68 @@
+/*
+ * File: CpuFeatures.cpp
+ * ---------------------
+ * Runtime detection of SIMD instruction sets.
+ */
+
+#include "CpuFeatures.h"
+
+#if FR_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#elif FR_X86 && defined(__GNUC__)
+#include <cpuid.h>
+#endif
+
+/*
+ * Function: detect_cpu_features
+ * -----------------------------
+ * Queries CPUID. AVX2 additionally requires the OS to save the YMM
+ * registers on context switches (XCR0 bits 1 and 2), AVX-512 also the
+ * opmask and ZMM registers (XCR0 bits 5 to 7). The L2 size comes
+ * from extended leaf 0x80000006 (ECX bits 31..16, in KB), which both
+ * Intel and AMD report.
+ */
+static CpuFeatures detect_cpu_features() {
+    CpuFeatures f;
+#if FR_X86 && defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    int maxLeaf = regs[0];
+
+    __cpuid(regs, 1);
+    f.sse2 = (regs[3] & (1 << 26)) != 0;
+    bool osxsave = (regs[2] & (1 << 27)) != 0;
+    bool avx = (regs[2] & (1 << 28)) != 0;
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+    bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+
+    if (maxLeaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        f.avx2 = avx && ymmEnabled && (regs[1] & (1 << 5)) != 0;
+        f.avx512 = avx && zmmEnabled && (regs[1] & (1 << 16)) != 0;
+    }
+
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned>(regs[0]) >= 0x80000006) {
+        __cpuid(regs, 0x80000006);
+        unsigned l2 = static_cast<unsigned>(regs[2]) >> 16;
+        if (l2 != 0) f.l2Cache = size_t(l2) * 1024;
+    }
+#elif FR_X86 && defined(__GNUC__)
+    __builtin_cpu_init();
+    f.sse2 = __builtin_cpu_supports("sse2");
+    f.avx2 = __builtin_cpu_supports("avx2");
+    f.avx512 = __builtin_cpu_supports("avx512f");
+
+    unsigned eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000006, &eax, &ebx, &ecx, &edx) && (ecx >> 16) != 0)
+        f.l2Cache = size_t(ecx >> 16) * 1024;
+#endif
+    return f;
+}
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect_cpu_features();
+    return features;
+}
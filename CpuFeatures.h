@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+
+// L2 cache size assumed when the CPU does not report one
+const size_t DEFAULT_L2_CACHE_BYTES = 256 * 1024;
+
+/*
+ * Structure: CpuFeatures
+ * ----------------------
+ * SIMD instruction sets available on the running CPU (and enabled by the
+ * operating system), and the size of its per-core L2 cache. Detected
+ * once on first use; used to pick vectorized code paths and block sizes
+ * at runtime so the program still runs on older machines.
+ *
+ * Fields:
+ *   - sse2    : 128-bit integer SIMD (always true on x64).
+ *   - avx2    : 256-bit integer SIMD.
+ *   - avx512  : 512-bit integer SIMD (AVX-512 Foundation).
+ *   - l2Cache : L2 cache size in bytes (DEFAULT_L2_CACHE_BYTES if unknown).
+ */
+struct CpuFeatures {
+    bool sse2 = false;
+    bool avx2 = false;
+    bool avx512 = false;
+    size_t l2Cache = DEFAULT_L2_CACHE_BYTES;
+};
+
+/*
+ * Function: cpu_features
+ * ----------------------
+ * Returns the features of the running CPU. All flags are false on
+ * non-x86 targets, which then use the scalar code paths.
+ */
+const CpuFeatures& cpu_features();
+
+// True when compiling for 32- or 64-bit x86, where SSE/AVX kernels exist
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FR_X86 1
+#else
+#define FR_X86 0
+#endif
+
+// GCC/Clang need the target attribute to emit AVX2 / AVX-512 code in
+// one function; MSVC accepts the intrinsics anywhere
+#if FR_X86 && (defined(__GNUC__) || defined(__clang__))
+#define FR_TARGET_AVX2 __attribute__((target("avx2")))
+#define FR_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define FR_TARGET_AVX2
+#define FR_TARGET_AVX512
+#endif
@@ -16,6 +16,15 @@ string Error::codeToString(ErrorCode code) {
     case ErrorCode::EMPTY_CLASS_NAME:      return "EMPTY_CLASS_NAME";
     case ErrorCode::EMPTY_RECORD_NAME:     return "EMPTY_RECORD_NAME";
     case ErrorCode::INVALID_NUMERIC_VALUE: return "INVALID_NUMERIC_VALUE";
+    case ErrorCode::NO_RECORDS:            return "NO_RECORDS";
+    case ErrorCode::NO_PROPERTIES_DEFINED: return "NO_PROPERTIES_DEFINED";
+    case ErrorCode::TYPE_MISMATCH:         return "TYPE_MISMATCH";
+    case ErrorCode::NO_CLASSES_OR_RULES:   return "NO_CLASSES_OR_RULES";
+    case ErrorCode::SYNTAX_ERROR_IN_CLASS_RULE: return "SYNTAX_ERROR_IN_CLASS_RULE";
+    case ErrorCode::INVALID_RULE_FORMAT:   return "INVALID_RULE_FORMAT";
+    case ErrorCode::VALUE_COUNT_ZERO:      return "VALUE_COUNT_ZERO";
+    case ErrorCode::RULE_BODY_EMPTY:       return "RULE_BODY_EMPTY";
+    case ErrorCode::INVALID_VALUE_IN_CONTAINS_VALUE: return "INVALID_VALUE_IN_CONTAINS_VALUE";
     default:                               return "UNKNOWN";
     }
 }
@@ -24,7 +33,10 @@ string Error::codeToString(ErrorCode code) {
  * Combines error details into a formatted string.
  */
 string Error::toString() const {
-    return "[" + const_cast<Error*>(this)->codeToString(code) + "] (Source: " + source + ")";
+    string text = "[" + const_cast<Error*>(this)->codeToString(code) + "] (Source: " + source;
+    if (column > 0)
+        text += ", column " + to_string(column);
+    return text + ")";
 }
 
 /*
@@ -33,7 +45,10 @@ string Error::toString() const {
 void Error::print() const {
     cerr << "[ERROR: "
         << const_cast<Error*>(this)->codeToString(code)
-        << "] — Source: " << source << endl;
+        << "] — Source: " << source;
+    if (column > 0)
+        cerr << ", column " << column;
+    cerr << endl;
 }
 
 /*
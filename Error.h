@@ -28,14 +28,19 @@ enum class ErrorCode {
     INVALID_VALUE_IN_CONTAINS_VALUE
 };
 
+// Number of ErrorCode values
+const size_t ERROR_CODE_COUNT = static_cast<size_t>(ErrorCode::INVALID_VALUE_IN_CONTAINS_VALUE) + 1;
+
 /*
  * Struct: Error
  * -------------
  * Describes a specific error with code, ErrorCode, and its source (e.g., Parser or Validator).
+ * Rule parsing errors also carry the column of the offending token.
  */
 struct Error {
     ErrorCode code;      // Type of the error
-    std::string source;  // Module or function where it occurred
+    const char* source = "";  // Module where it occurred (static string, e.g. "Parser")
+    size_t column = 0;        // 1-based column in the source line (0 if unknown)
 
     // Converts the error code to human-readable text
     std::string codeToString(ErrorCode code);  // no longer static
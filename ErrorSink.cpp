@@ -0,0 +1,65 @@
+/*
+ * File: ErrorSink.cpp
+ * -------------------
+ * Implements the bounded error collector.
+ */
+
+#include "ErrorSink.h"
+#include <algorithm>
+
+/*
+ * Constructor: ErrorSink
+ * ----------------------
+ * Limits examplesPerCode to MAX_ERROR_EXAMPLES and reserves room for
+ * up to DEFAULT_ERROR_EXAMPLES examples of every error code.
+ */
+ErrorSink::ErrorSink(size_t examplesPerCode)
+    : examplesPerCode_(std::min(examplesPerCode, MAX_ERROR_EXAMPLES)) {
+    examples_.reserve(std::min(examplesPerCode_, DEFAULT_ERROR_EXAMPLES) * ERROR_CODE_COUNT);
+}
+
+/*
+ * Method: keep
+ * ------------
+ * Stores an example unless its code already has examplesPerCode_ of them.
+ */
+void ErrorSink::keep(const ErrorExample& example) {
+    size_t& kept = kept_[static_cast<size_t>(example.code)];
+    if (kept < examplesPerCode_) {
+        kept++;
+        examples_.push_back(example);
+    }
+}
+
+/*
+ * Method: report
+ * --------------
+ * Counts the error and keeps it as an example if there is room.
+ */
+void ErrorSink::report(ErrorCode code, const char* source, size_t line, size_t column) {
+    counts_[static_cast<size_t>(code)]++;
+    total_++;
+    keep({ code, source, file_, line, column });
+}
+
+void ErrorSink::report(const Error& error, size_t line) {
+    report(error.code, error.source, line, error.column);
+}
+
+/*
+ * Method: merge
+ * -------------
+ * Adds the counts of other and its examples, in order, while there is
+ * room. Merging chunks in input order keeps the first examples of the
+ * whole input.
+ */
+void ErrorSink::merge(const ErrorSink& other, size_t lineOffset) {
+    for (size_t i = 0; i < ERROR_CODE_COUNT; i++)
+        counts_[i] += other.counts_[i];
+    total_ += other.total_;
+
+    for (ErrorExample example : other.examples_) {
+        if (example.line > 0) example.line += lineOffset;
+        keep(example);
+    }
+}
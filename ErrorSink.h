@@ -0,0 +1,92 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "Error.h"
+
+/*
+ * File: ErrorSink.h
+ * -----------------
+ * Bounded collector of parsing errors with their locations.
+ */
+
+// Examples kept per error code unless configured otherwise
+const size_t DEFAULT_ERROR_EXAMPLES = 5;
+
+// Most examples kept per error code; larger requests are limited to it
+const size_t MAX_ERROR_EXAMPLES = 10000;
+
+/*
+ * Structure: ErrorExample
+ * -----------------------
+ * One reported error and where it was found.
+ *
+ * Fields:
+ *   - code   : type of the error.
+ *   - source : module that reported it (static string, e.g. "Parser").
+ *   - file   : input file (static string or argv entry, "" if unknown).
+ *   - line   : 1-based line number (0 if unknown).
+ *   - column : 1-based column in that line (0 if unknown).
+ */
+struct ErrorExample {
+    ErrorCode code;
+    const char* source;
+    const char* file;
+    size_t line;
+    size_t column;
+};
+
+/*
+ * Class: ErrorSink
+ * ----------------
+ * Counts every reported error exactly, per code, but keeps details only
+ * for the first N errors of each code, in report order (N is at most
+ * MAX_ERROR_EXAMPLES). The constructor allocates room for the default
+ * number of examples per code; the buffer only grows past that when N
+ * is larger, and never beyond N examples per code, however many errors
+ * a file contains.
+ *
+ * Parallel parsers report into one sink per chunk and merge the chunks
+ * in input order; line numbers of a chunk are then shifted by the lines
+ * of the chunks before it.
+ *
+ * Example:
+ *   ErrorSink errors;
+ *   errors.setFile("items.txt");
+ *   errors.report(ErrorCode::INVALID_RECORD, "Parser", 12, 5);
+ *   errors.count(ErrorCode::INVALID_RECORD);  // 1
+ */
+class ErrorSink {
+public:
+    explicit ErrorSink(size_t examplesPerCode = DEFAULT_ERROR_EXAMPLES);
+
+    // File stamped on subsequent reports (must outlive the sink)
+    void setFile(const char* file) { file_ = file; }
+    const char* file() const { return file_; }
+
+    // Records one error
+    void report(ErrorCode code, const char* source, size_t line, size_t column = 0);
+    void report(const Error& error, size_t line);
+
+    // Appends the errors of another sink, shifting its line numbers
+    void merge(const ErrorSink& other, size_t lineOffset = 0);
+
+    // Exact number of errors reported with a code / in total
+    size_t count(ErrorCode code) const { return counts_[static_cast<size_t>(code)]; }
+    size_t total() const { return total_; }
+    bool empty() const { return total_ == 0; }
+
+    // First examplesPerCode() errors of each code, in report order
+    const std::vector<ErrorExample>& examples() const { return examples_; }
+    size_t examplesPerCode() const { return examplesPerCode_; }
+
+private:
+    void keep(const ErrorExample& example);
+
+    size_t examplesPerCode_;
+    const char* file_ = "";
+    size_t total_ = 0;
+    std::array<size_t, ERROR_CODE_COUNT> counts_{};  // Reported errors per code
+    std::array<size_t, ERROR_CODE_COUNT> kept_{};    // Examples kept per code
+    std::vector<ErrorExample> examples_;             // At most examplesPerCode_ per code
+};
@@ -17,7 +17,7 @@ namespace RecordClassifierTests
         {
             Property color{ {1, 2} };
             Property size{ {10, 20} };
-            Record wardrobe{ "Wardrobe", {{"color", color}, {"size", size}} };
+            Record wardrobe{ "Wardrobe", {{intern_property("color"), color}, {intern_property("size"), size}} };
 
             std::vector<Record> records{ wardrobe };
             auto res = validate_records(records);
@@ -59,7 +59,7 @@ namespace RecordClassifierTests
         {
             Property color{ {1} };
             Property coating{ {44} };
-            Record table{ "Table", {{"color", color}, {"coating", coating}} };
+            Record table{ "Table", {{intern_property("color"), color}, {intern_property("coating"), coating}} };
 
             Rule r1{ RuleType::HAS_PROPERTY, "coating", 0, 0, {} };
             ClassRule class1{ "With coating", {r1} };
@@ -72,7 +72,7 @@ namespace RecordClassifierTests
         TEST_METHOD(Classify_NoMatch)
         {
             Property color{ {2} };
-            Record lamp{ "Lamp", {{"color", color}} };
+            Record lamp{ "Lamp", {{intern_property("color"), color}} };
 
             Rule r1{ RuleType::EQUALS_EXACTLY, "coating", 0, 0, {44, 21} };
             ClassRule class1{ "Matte", {r1} };
@@ -80,5 +80,120 @@ namespace RecordClassifierTests
             auto result = classify({ lamp }, { class1 });
             Assert::IsTrue(result["Matte"].empty());
         }
+
+        TEST_METHOD(ClassifyRecord_Streamed_MatchesClassify)
+        {
+            Record car{ "Car", {{intern_property("color"), {{2}}}, {intern_property("doors"), {{4}}}} };
+            Record bike{ "Bike", {{intern_property("color"), {{3}}}, {intern_property("wheels"), {{2}}}} };
+            Record bus{ "Bus", {{intern_property("color"), {{2, 3}}}, {intern_property("doors"), {{2}}}} };
+            std::vector<Record> records{ car, bike, bus };
+
+            Rule hasDoors{ RuleType::HAS_PROPERTY, "doors", 0, 0, {} };
+            Rule red{ RuleType::CONTAINS_VALUE, "color", 0, 2, {} };
+            Rule twoWheels{ RuleType::PROPERTY_SIZE, "wheels", 1, 0, {} };
+            // "Red" appears twice: results of both classes are concatenated
+            std::vector<ClassRule> classes{ { "Has doors", {hasDoors} }, { "Red", {red} },
+                { "Wheels", {twoWheels} }, { "Red", {hasDoors} }, { "Unused", {red, twoWheels} } };
+
+            std::vector<std::vector<std::string>> matches(classes.size());
+            for (const auto& r : records)
+                classify_record(r, classes, matches);
+            auto streamed = collect_class_matches(classes, matches);
+
+            auto expected = classify(records, classes);
+            Assert::IsTrue(expected == streamed);
+            Assert::AreEqual(size_t(4), streamed["Red"].size());
+            Assert::IsTrue(streamed.find("Unused") == streamed.end());
+        }
+
+        TEST_METHOD(RuleTable_MergesDuplicateRules)
+        {
+            Rule red{ RuleType::CONTAINS_VALUE, "color", 0, 2, {} };
+            Rule redAgain{ RuleType::CONTAINS_VALUE, "COLOR", 0, 2, {} };
+            Rule hasDoors{ RuleType::HAS_PROPERTY, "doors", 0, 0, {} };
+            std::vector<ClassRule> classes{ { "Red", {red} }, { "Red doors", {hasDoors, redAgain} },
+                { "Empty", {} }, { "Doors", {hasDoors} } };
+
+            RuleTable table(classes);
+            Assert::AreEqual(size_t(2), table.ruleCount());
+            Assert::AreEqual(size_t(4), table.instanceCount());
+            Assert::AreEqual(size_t(4), table.classCount());
+            Assert::AreEqual(size_t(0), table.classRules(2).size());
+            Assert::AreEqual(table.classRules(0).data[0], table.classRules(1).data[1]);
+            Assert::AreEqual(table.classRules(1).data[0], table.classRules(3).data[0]);
+        }
+
+        TEST_METHOD(Classify_RuleTable_MatchesClassify)
+        {
+            Record car{ "Car", {{intern_property("color"), {{2}}}, {intern_property("doors"), {{4}}}} };
+            Record bike{ "Bike", {{intern_property("color"), {{3}}}, {intern_property("wheels"), {{2}}}} };
+            Record bus{ "Bus", {{intern_property("color"), {{2, 3}}}, {intern_property("doors"), {{2}}}} };
+            std::vector<Record> records{ car, bike, bus };
+
+            Rule hasDoors{ RuleType::HAS_PROPERTY, "doors", 0, 0, {} };
+            Rule red{ RuleType::CONTAINS_VALUE, "color", 0, 2, {} };
+            Rule twoDoors{ RuleType::EQUALS_EXACTLY, "doors", 0, 0, {2} };
+            std::vector<ClassRule> classes{ { "Red", {red} }, { "Red doors", {red, hasDoors} },
+                { "Bus", {red, twoDoors} }, { "Red", {hasDoors} }, { "Any", {} } };
+
+            RuleTable table(classes);
+            auto expected = classify(records, classes);
+            Assert::IsTrue(expected == classify(RecordStore(records), table, classes));
+
+            RuleMemo memo;
+            std::vector<std::vector<std::string>> matches(classes.size());
+            for (const auto& r : records)
+                classify_record(r, table, matches, memo);
+            Assert::IsTrue(expected == collect_class_matches(classes, matches));
+        }
+
+        TEST_METHOD(Classify_Tiled_MatchesClassify)
+        {
+            std::vector<Record> records;
+            for (int i = 0; i < 10; i++) {
+                Record r{ "R" + std::to_string(i), {{intern_property("color"), {{i % 3, i}}}} };
+                if (i % 4 == 0) r.addProperty(intern_property("doors"), &i, 1);
+                records.push_back(r);
+            }
+            Rule hasDoors{ RuleType::HAS_PROPERTY, "doors", 0, 0, {} };
+            Rule red{ RuleType::CONTAINS_VALUE, "color", 0, 2, {} };
+            Rule green{ RuleType::CONTAINS_VALUE, "color", 0, 1, {} };
+            std::vector<ClassRule> classes{ { "Red", {red} }, { "Red doors", {red, hasDoors} },
+                { "Green", {green} }, { "Red", {hasDoors, green} }, { "Any", {} } };
+
+            RecordStore store(records);
+            RuleTable table(classes);
+            auto expected = classify(records, classes);
+            for (size_t recordBlock : { 1, 3, 64 })
+                for (size_t classBlock : { 1, 2, 5 })
+                    Assert::IsTrue(expected == classify(store, table, classes, { recordBlock, classBlock }));
+
+            ThreadPool pool(3);
+            for (size_t recordBlock : { 0, 1, 4 })
+                Assert::IsTrue(expected == classify(store, table, classes, pool, { recordBlock, 2 }));
+
+            ClassifyTiling tuned = tune_tiling(store, table, 1 << 20, { 0, 2 });
+            Assert::AreEqual(size_t(2), tuned.classes);
+            Assert::IsTrue(tuned.records >= MIN_TILE_RECORDS && tuned.records <= MAX_TILE_RECORDS);
+            Assert::IsTrue(tune_tiling(store, table, 256).classes >= 1);
+            Assert::IsTrue(tune_tiling(store, table, 1 << 20, {}, 4).records <= 1);
+        }
+
+        TEST_METHOD(SameRule_ComparesOnlyTheOperandOfItsType)
+        {
+            Rule a{ RuleType::CONTAINS_VALUE, "color", 5, 2, {} };
+            Rule b{ RuleType::CONTAINS_VALUE, "Color", 0, 2, {7} };
+            Rule c{ RuleType::CONTAINS_VALUE, "color", 0, 3, {} };
+            Rule d{ RuleType::HAS_PROPERTY, "color", 1, 2, {} };
+            Rule e{ RuleType::HAS_PROPERTY, "color", 0, 0, {} };
+
+            Assert::IsTrue(same_rule(a, b));
+            Assert::AreEqual(RuleHash()(a), RuleHash()(b));
+            Assert::IsFalse(same_rule(a, c));
+            Assert::IsFalse(same_rule(a, d));
+            Assert::IsTrue(same_rule(d, e));
+            Assert::IsFalse(same_rule(Rule{ RuleType::EQUALS_EXACTLY, "color", 0, 0, {1, 2} },
+                Rule{ RuleType::EQUALS_EXACTLY, "color", 0, 0, {2, 1} }));
+        }
     };
 }
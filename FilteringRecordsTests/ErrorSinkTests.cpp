@@ -0,0 +1,78 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <cstdint>
+#include "../ErrorSink.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: ErrorSinkTests
+ * --------------------------
+ * Tests the bounded error collector: exact counts per code, at most N
+ * located examples per code, and merging of per-chunk sinks.
+ */
+
+namespace ErrorSinkTests
+{
+    TEST_CLASS(ErrorSinkTests)
+    {
+    public:
+
+        TEST_METHOD(Report_CountsAllKeepsFirstExamples)
+        {
+            ErrorSink errors(2);
+            errors.setFile("items.txt");
+            for (size_t line = 1; line <= 1000; line++)
+                errors.report(ErrorCode::INVALID_RECORD, "Parser", line);
+            errors.report(ErrorCode::DUPLICATE_PROPERTY, "Parser", 7, 12);
+
+            Assert::AreEqual(size_t(1001), errors.total());
+            Assert::AreEqual(size_t(1000), errors.count(ErrorCode::INVALID_RECORD));
+            Assert::AreEqual(size_t(1), errors.count(ErrorCode::DUPLICATE_PROPERTY));
+            Assert::AreEqual(size_t(3), errors.examples().size());
+            Assert::AreEqual(size_t(1), errors.examples()[0].line);
+            Assert::AreEqual(size_t(2), errors.examples()[1].line);
+            Assert::AreEqual(size_t(12), errors.examples()[2].column);
+            Assert::AreEqual("items.txt", errors.examples()[2].file);
+        }
+
+        TEST_METHOD(Report_DoesNotGrowExampleBuffer)
+        {
+            ErrorSink errors(1);
+            size_t capacity = errors.examples().capacity();
+            for (size_t i = 0; i < 10000; i++)
+                errors.report(static_cast<ErrorCode>(i % ERROR_CODE_COUNT), "Parser", i + 1);
+
+            Assert::AreEqual(capacity, errors.examples().capacity());
+            Assert::AreEqual(ERROR_CODE_COUNT, errors.examples().size());
+        }
+
+        TEST_METHOD(Construct_LimitsHugeExampleCount)
+        {
+            ErrorSink errors(SIZE_MAX);
+            Assert::IsTrue(errors.examples().capacity() <= DEFAULT_ERROR_EXAMPLES * ERROR_CODE_COUNT);
+            for (size_t line = 1; line <= MAX_ERROR_EXAMPLES + 10; line++)
+                errors.report(ErrorCode::INVALID_RECORD, "Parser", line);
+
+            Assert::AreEqual(MAX_ERROR_EXAMPLES, errors.examples().size());
+            Assert::AreEqual(MAX_ERROR_EXAMPLES + 10, errors.count(ErrorCode::INVALID_RECORD));
+        }
+
+        TEST_METHOD(Merge_ShiftsLinesAndKeepsOrder)
+        {
+            ErrorSink total(2), first(2), second(2);
+            first.report(ErrorCode::INVALID_RECORD, "Parser", 3);
+            second.report(ErrorCode::INVALID_RECORD, "Parser", 1);
+            second.report(ErrorCode::INVALID_RECORD, "Parser", 4);
+
+            total.merge(first, 0);
+            total.merge(second, 10);
+
+            Assert::AreEqual(size_t(3), total.count(ErrorCode::INVALID_RECORD));
+            Assert::AreEqual(size_t(2), total.examples().size());
+            Assert::AreEqual(size_t(3), total.examples()[0].line);
+            Assert::AreEqual(size_t(11), total.examples()[1].line);
+        }
+    };
+}
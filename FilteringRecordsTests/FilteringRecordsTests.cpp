@@ -2,10 +2,12 @@
 #include <CppUnitTest.h>
 #include <vector>
 #include <string>
+#include <thread>
 #include "../Record.h"
 #include "../Rule.h"
 #include "../Validation.h"
 #include "../Classifier.h"
+#include "../Parser.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace std;
@@ -32,8 +34,8 @@ namespace FilteringRecordsTests
         //---------------------------------------------
         TEST_METHOD(ValidateRecords_Correct)
         {
-            Record r1{ "Wardrobe", {{"color", {"color", {1, 2}}}, {"size", {"size", {10, 40, 60}}}} };
-            Record r2{ "Table", {{"color", {"color", {1, 4}}}, {"size", {"size", {20, 40}}}, {"coating", {"coating", {44}}}} };
+            Record r1{ "Wardrobe", {{intern_property("color"), {{1, 2}}}, {intern_property("size"), {{10, 40, 60}}}} };
+            Record r2{ "Table", {{intern_property("color"), {{1, 4}}}, {intern_property("size"), {{20, 40}}}, {intern_property("coating"), {{44}}}} };
 
             vector<Record> records = { r1, r2 };
             auto result = validate_records(records);
@@ -50,7 +52,7 @@ namespace FilteringRecordsTests
         }
         TEST_METHOD(ValidateRecords_NoDuplicateProperty)
         {
-            Record r{ "Chair", {{"size", {"size", {10}}}, {"width", {"width", {20}}}} };
+            Record r{ "Chair", {{intern_property("size"), {{10}}}, {intern_property("width"), {{20}}}} };
             vector<Record> records = { r };
             auto result = validate_records(records);
             Assert::IsTrue(result.isCorrect);
@@ -66,7 +68,7 @@ namespace FilteringRecordsTests
 
         TEST_METHOD(ValidateRecords_NegativeValues)
         {
-            Record r{ "Shelf", {{"depth", {"depth", {-5}}}} };
+            Record r{ "Shelf", {{intern_property("depth"), {{-5}}}} };
             vector<Record> records = { r };
             auto result = validate_records(records);
             Assert::IsTrue(result.isCorrect);
@@ -74,9 +76,9 @@ namespace FilteringRecordsTests
 
         TEST_METHOD(ValidateRecords_MultipleValidRecords)
         {
-            Record r1{ "Wardrobe", {{"color", {"color", {1}}}} };
-            Record r2{ "Table", {{"size", {"size", {10}}}} };
-            Record r3{ "Sofa", {{"height", {"height", {20}}}} };
+            Record r1{ "Wardrobe", {{intern_property("color"), {{1}}}} };
+            Record r2{ "Table", {{intern_property("size"), {{10}}}} };
+            Record r3{ "Sofa", {{intern_property("height"), {{20}}}} };
             vector<Record> records = { r1, r2, r3 };
             auto result = validate_records(records);
             Assert::IsTrue(result.isCorrect);
@@ -84,7 +86,7 @@ namespace FilteringRecordsTests
 
         TEST_METHOD(ValidateRecords_EmptyName)
         {
-            Record r{ "", {{"color", {"color", {1}}}} };
+            Record r{ "", {{intern_property("color"), {{1}}}} };
             vector<Record> records = { r };
             auto result = validate_records(records);
             Assert::IsFalse(result.isCorrect);
@@ -92,8 +94,8 @@ namespace FilteringRecordsTests
 
         TEST_METHOD(ValidateRecords_DuplicateRecordNames)
         {
-            Record r1{ "Wardrobe", {{"color", {"color", {1}}}} };
-            Record r2{ "Wardrobe", {{"size", {"size", {2}}}} };
+            Record r1{ "Wardrobe", {{intern_property("color"), {{1}}}} };
+            Record r2{ "Wardrobe", {{intern_property("size"), {{2}}}} };
             vector<Record> records = { r1, r2 };
             auto result = validate_records(records);
             Assert::IsTrue(result.isCorrect);
@@ -103,7 +105,7 @@ namespace FilteringRecordsTests
         {
             Record big{ "Big", {} };
             for (int i = 0; i < 1000; i++)
-                big.properties["p" + to_string(i)] = { "p" + to_string(i), {i} };
+                big.addProperty(intern_property("p" + to_string(i)), &i, 1);
             vector<Record> records = { big };
             auto result = validate_records(records);
             Assert::IsTrue(result.isCorrect);
@@ -111,10 +113,54 @@ namespace FilteringRecordsTests
 
         TEST_METHOD(ValidateRecords_DifferentCaseProperty)
         {
-            Record r{ "Item", {{"Size", {"Size", {10}}}, {"size", {"size", {20}}}} };
-            vector<Record> records = { r };
-            auto result = validate_records(records);
-            Assert::IsFalse(result.isCorrect);
+            // Names differing in case are one property: a record cannot
+            // hold both, and the parser rejects such a line
+            Assert::AreEqual(intern_property("size"), intern_property("Size"));
+            Record r;
+            Error error;
+            Assert::IsFalse(parse_record_line("Item: Size=[10], size=[20]", r, error));
+            Assert::IsTrue(error.code == ErrorCode::DUPLICATE_PROPERTY);
+        }
+
+        TEST_METHOD(InternProperty_SameIdOnEveryThread)
+        {
+            // Each thread answers repeated names from its own cache; the
+            // ids must still agree with the shared dictionary
+            const vector<string> names = { "shelfdepth", "ShelfDepth", "shelfwidth", "SHELFWIDTH" };
+            vector<vector<PropertyId>> ids(4);
+            vector<thread> threads;
+            for (size_t t = 0; t < ids.size(); t++) {
+                threads.emplace_back([&names, &ids, t] {
+                    for (int round = 0; round < 2; round++)
+                        for (const string& name : names)
+                            ids[t].push_back(intern_property(name));
+                });
+            }
+            for (thread& t : threads) t.join();
+
+            for (const auto& local : ids) {
+                Assert::AreEqual(size_t(8), local.size());
+                for (size_t i = 0; i < local.size(); i++)
+                    Assert::AreEqual(find_property(names[i % names.size()]), local[i]);
+            }
+            Assert::AreEqual(intern_property("shelfdepth"), intern_property("SHELFDEPTH"));
+            Assert::IsTrue(intern_property("shelfdepth") != intern_property("shelfwidth"));
+        }
+
+        TEST_METHOD(Record_AddProperty_KeepsEntriesSorted)
+        {
+            Record r;
+            int depth[] = { 3, 4 }, color[] = { 1 };
+            Assert::IsTrue(r.addProperty(intern_property("depth"), depth, 2));
+            Assert::IsTrue(r.addProperty(intern_property("color"), color, 1));
+            Assert::IsFalse(r.addProperty(intern_property("Color"), depth, 2));
+
+            Assert::AreEqual(size_t(2), r.properties.size());
+            Assert::AreEqual(size_t(3), r.values.size());
+            Assert::IsTrue(r.properties[0].id < r.properties[1].id);
+            Assert::AreEqual(size_t(1), r.valuesOf(*r.getProperty("COLOR")).size());
+            Assert::AreEqual(4, r.valuesOf(*r.getProperty("depth"))[1]);
+            Assert::IsNull(r.getProperty("width"));
         }
 
         //---------------------------------------------
@@ -146,8 +192,8 @@ namespace FilteringRecordsTests
         TEST_METHOD(Classify_Simple)
         {
             // Arrange
-            Record wardrobe{ "Wardrobe", {{"color", {"color", {1, 2}}}, {"size", {"size", {10, 40, 60}}}} };
-            Record table{ "Table", {{"color", {"color", {1, 4}}}, {"size", {"size", {20, 40}}}, {"coating", {"coating", {44}}}} };
+            Record wardrobe{ "Wardrobe", {{intern_property("color"), {{1, 2}}}, {intern_property("size"), {{10, 40, 60}}}} };
+            Record table{ "Table", {{intern_property("color"), {{1, 4}}}, {intern_property("size"), {{20, 40}}}, {intern_property("coating"), {{44}}}} };
             vector<Record> records = { wardrobe, table };
 
             Rule r1{ RuleType::HAS_PROPERTY, "coating" };
@@ -171,7 +217,7 @@ namespace FilteringRecordsTests
 
         TEST_METHOD(Classify_EmptyRules)
         {
-            Record r{ "Box", {{"weight", {"weight", {10}}}} };
+            Record r{ "Box", {{intern_property("weight"), {{10}}}} };
             vector<Record> records = { r };
             vector<ClassRule> classes;
             auto result = classify(records, classes);
@@ -180,8 +226,8 @@ namespace FilteringRecordsTests
 
         TEST_METHOD(Classify_MultipleMatches)
         {
-            Record car{ "Car", {{"color", {"color", {2}}}, {"doors", {"doors", {4}}}, {"engine", {"engine", {2000}}}} };
-            Record bus{ "Bus", {{"color", {"color", {2, 3}}}, {"doors", {"doors", {2}}}, {"seats", {"seats", {40}}}} };
+            Record car{ "Car", {{intern_property("color"), {{2}}}, {intern_property("doors"), {{4}}}, {intern_property("engine"), {{2000}}}} };
+            Record bus{ "Bus", {{intern_property("color"), {{2, 3}}}, {intern_property("doors"), {{2}}}, {intern_property("seats"), {{40}}}} };
             vector<Record> records = { car, bus };
 
             Rule r1{ RuleType::HAS_PROPERTY, "doors" };
@@ -0,0 +1,187 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include "../IncrementalParser.h"
+#include "../InputFile.h"
+#include "../Parser.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: IncrementalParserTests
+ * ----------------------------------
+ * Tests incremental parsing of the items file: only changed lines are
+ * parsed, and the outputs always match a full parse_records() run.
+ */
+
+namespace IncrementalParserTests
+{
+    TEST_CLASS(IncrementalParserTests)
+    {
+    public:
+
+        static bool sameRecords(const vector<Record>& a, const vector<Record>& b)
+        {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); i++) {
+                if (a[i].name != b[i].name || a[i].properties.size() != b[i].properties.size())
+                    return false;
+                for (const auto& entry : a[i].properties) {
+                    const PropertyEntry* p = b[i].getProperty(entry.id);
+                    PropertyValues x = a[i].valuesOf(entry);
+                    if (!p || !equal(x.begin(), x.end(), b[i].valuesOf(*p).begin(), b[i].valuesOf(*p).end()))
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        TEST_METHOD(SecondRun_ReusesUnchangedLines)
+        {
+            string first = "Car: color = [1, 2]\nBike wheels = [2]\nLamp: size = [3]\n";
+            string second = "Car: color = [1, 2]\nBike wheels = [2]\nLamp: size = [4]\nBus: seats = [40]\n";
+
+            // First run: no sidecar, everything is parsed
+            {
+                IncrementalParser parser;
+                vector<Record> records;
+                ErrorSink errors;
+                vector<string_view> rejected;
+                parser.parse(first, records, errors, rejected);
+                Assert::AreEqual(size_t(0), parser.reusedLines());
+                Assert::AreEqual(size_t(3), parser.parsedLines());
+                Assert::IsTrue(parser.write("test_items.lines", records));
+            }
+
+            // Second run: two lines are unchanged
+            IncrementalParser parser;
+            InputFile sidecar;
+            Assert::IsTrue(sidecar.open("test_items.lines"));
+            Assert::IsTrue(parser.load(sidecar.data()));
+
+            vector<Record> records, expected;
+            ErrorSink errors, expectedErrors;
+            vector<string_view> rejected, expectedRejected;
+            parser.parse(second, records, errors, rejected);
+            parse_records(second, expected, expectedErrors, expectedRejected);
+
+            Assert::AreEqual(size_t(2), parser.reusedLines());
+            Assert::AreEqual(size_t(2), parser.parsedLines());
+            Assert::IsTrue(sameRecords(expected, records));
+            Assert::AreEqual(expectedRejected.size(), rejected.size());
+            Assert::AreEqual(string(expectedRejected[0]), string(rejected[0]));
+            Assert::AreEqual(expectedErrors.total(), errors.total());
+            Assert::AreEqual(size_t(2), errors.examples()[0].line);
+            Assert::AreEqual(expectedErrors.examples()[0].column, errors.examples()[0].column);
+
+            sidecar.close();
+            remove("test_items.lines");
+        }
+
+        TEST_METHOD(SecondRun_ReindentedRejectedLine_ReportsNewColumn)
+        {
+            string first = "A: size = [1]\nB: color=[1], color=[2]\n";
+            string second = "A: size = [1]\n        B: color=[1], color=[2]\n";
+            {
+                IncrementalParser parser;
+                vector<Record> records;
+                ErrorSink errors;
+                vector<string_view> rejected;
+                parser.parse(first, records, errors, rejected);
+                Assert::IsTrue(parser.write("test_items_indent.lines", records));
+            }
+
+            IncrementalParser parser;
+            InputFile sidecar;
+            Assert::IsTrue(sidecar.open("test_items_indent.lines"));
+            Assert::IsTrue(parser.load(sidecar.data()));
+
+            vector<Record> records, expected;
+            ErrorSink errors, expectedErrors;
+            vector<string_view> rejected, expectedRejected;
+            parser.parse(second, records, errors, rejected);
+            parse_records(second, expected, expectedErrors, expectedRejected);
+
+            // The rejected line was replayed, not parsed again
+            Assert::AreEqual(size_t(2), parser.reusedLines());
+            Assert::AreEqual(size_t(1), errors.total());
+            Assert::AreEqual(size_t(2), errors.examples()[0].line);
+            Assert::IsTrue(expectedErrors.examples()[0].column > 8);
+            Assert::AreEqual(expectedErrors.examples()[0].column, errors.examples()[0].column);
+
+            sidecar.close();
+            remove("test_items_indent.lines");
+        }
+
+        TEST_METHOD(ChangedLines_ParsedInChunks_MatchFullParse)
+        {
+            // The changed lines alone fill several chunks; every 97th line
+            // of the first text and some of the changed ones are rejected
+            string first, second, weights = "weight = [";
+            for (int v = 0; v < 30; v++) weights += to_string(1000 + v) + (v < 29 ? ", " : "]");
+            for (int i = 0; i < 40000; i++) {
+                string line = (i % 97 == 0) ? "Broken" + to_string(i) + " size=[1]\n"
+                    : "Item" + to_string(i) + ": size = [" + to_string(i) + "], color = [1, 2]\n";
+                first += line;
+                second += (i % 3 == 0) ? "  " + line : line;
+                if (i % 5 == 0 && i % 485 == 0) second += "BrokenExtra" + to_string(i) + " size=[1]\n";
+                else if (i % 5 == 0) second += "Extra" + to_string(i) + ": size = [" + to_string(i) + "], " + weights + "\n";
+            }
+
+            {
+                RecordArena arena;  // Declared first: outlives the records
+                IncrementalParser parser;
+                vector<Record> records;
+                ErrorSink errors;
+                vector<string_view> rejected;
+                parser.parse(first, records, errors, rejected, 3, &arena);
+                Assert::IsFalse(parser.upToDate());
+                Assert::IsTrue(parser.write("test_items_chunks.lines", records));
+            }
+
+            RecordArena arena;
+            IncrementalParser parser;
+            InputFile sidecar;
+            Assert::IsTrue(sidecar.open("test_items_chunks.lines"));
+            Assert::IsTrue(parser.load(sidecar.data()));
+
+            vector<Record> records, expected;
+            ErrorSink errors(100), expectedErrors(100);
+            vector<string_view> rejected, expectedRejected;
+            parser.parse(second, records, errors, rejected, 3, &arena);
+            parse_records(second, expected, expectedErrors, expectedRejected);
+
+            Assert::AreEqual(size_t(40000), parser.reusedLines());
+            Assert::AreEqual(size_t(8000), parser.parsedLines());
+            Assert::IsFalse(parser.upToDate());
+            Assert::IsTrue(sameRecords(expected, records));
+            Assert::IsTrue(expectedRejected == rejected);
+            Assert::AreEqual(expectedErrors.total(), errors.total());
+            for (size_t i = 0; i < expectedErrors.examples().size(); i++) {
+                Assert::AreEqual(expectedErrors.examples()[i].line, errors.examples()[i].line);
+                Assert::AreEqual(expectedErrors.examples()[i].column, errors.examples()[i].column);
+            }
+
+            // Parsing the first text again meets only known lines, all of them
+            vector<Record> again;
+            ErrorSink againErrors;
+            vector<string_view> againRejected;
+            IncrementalParser reload;
+            Assert::IsTrue(reload.load(sidecar.data()));
+            reload.parse(first, again, againErrors, againRejected);
+            Assert::IsTrue(reload.upToDate());
+
+            sidecar.close();
+            remove("test_items_chunks.lines");
+        }
+
+        TEST_METHOD(Load_NotASidecar_ShouldFail)
+        {
+            IncrementalParser parser;
+            Assert::IsFalse(parser.load("Car: color = [1, 2]\n"));
+        }
+    };
+}
@@ -0,0 +1,87 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "../InputFile.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: InputFileTests
+ * --------------------------
+ * Tests the memory-mapped input reader and the in-place line splitter
+ * used by main() to walk items and rules files.
+ */
+
+namespace InputFileTests
+{
+    TEST_CLASS(InputFileTests)
+    {
+    public:
+
+        TEST_METHOD(NextLine_SplitsLikeGetline)
+        {
+            string_view text = "first\nsecond\r\n\nlast";
+            string_view line;
+
+            Assert::IsTrue(next_line(text, line));
+            Assert::AreEqual("first"s, string(line));
+            Assert::IsTrue(next_line(text, line));
+            Assert::AreEqual("second\r"s, string(line));
+            Assert::IsTrue(next_line(text, line));
+            Assert::IsTrue(line.empty());
+            Assert::IsTrue(next_line(text, line));
+            Assert::AreEqual("last"s, string(line));
+            Assert::IsFalse(next_line(text, line));
+        }
+
+        TEST_METHOD(NextLine_TrailingNewline_NoExtraLine)
+        {
+            string_view text = "only\n";
+            string_view line;
+
+            Assert::IsTrue(next_line(text, line));
+            Assert::AreEqual("only"s, string(line));
+            Assert::IsFalse(next_line(text, line));
+        }
+
+        TEST_METHOD(Open_RegularFile_IsMapped)
+        {
+            {
+                ofstream out("test_input_file.txt", ios::binary);
+                out << "Car: color = [2]\nBike: wheels = [2]\n";
+            }
+
+            InputFile in;
+            Assert::IsTrue(in.open("test_input_file.txt"));
+            Assert::IsTrue(in.isMapped());
+            Assert::AreEqual("Car: color = [2]\nBike: wheels = [2]\n"s, string(in.data()));
+
+            in.close();
+            Assert::IsTrue(in.data().empty());
+            remove("test_input_file.txt");
+        }
+
+        TEST_METHOD(Open_EmptyFile_FallsBackToBuffer)
+        {
+            {
+                ofstream out("test_input_empty.txt", ios::binary);
+            }
+
+            InputFile in;
+            Assert::IsTrue(in.open("test_input_empty.txt"));
+            Assert::IsFalse(in.isMapped());
+            Assert::IsTrue(in.data().empty());
+            in.close();
+            remove("test_input_empty.txt");
+        }
+
+        TEST_METHOD(Open_MissingFile_ShouldFail)
+        {
+            InputFile in;
+            Assert::IsFalse(in.open("no_such_input_file.txt"));
+        }
+    };
+}
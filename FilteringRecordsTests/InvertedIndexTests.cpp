@@ -0,0 +1,119 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <string>
+#include <vector>
+#include "../InvertedIndex.h"
+#include "../Classifier.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: InvertedIndexTests
+ * ------------------------------
+ * Tests the posting lists of the inverted index, their intersection,
+ * and that classifying through the index or through rule bitmaps gives
+ * the same result as scanning the records.
+ */
+
+namespace InvertedIndexTests
+{
+    TEST_CLASS(InvertedIndexTests)
+    {
+    public:
+
+        static vector<uint32_t> ids(PostingView v)
+        {
+            return vector<uint32_t>(v.begin(), v.end());
+        }
+
+        TEST_METHOD(Postings_ListRecordsInOrder)
+        {
+            vector<Record> records = {
+                Record{ "Wardrobe", {{intern_property("color"), {{1, 2, 2}}}, {intern_property("size"), {{10, 40}}}} },
+                Record{ "Lamp", {{intern_property("height"), {{}}}} },
+                Record{ "Table", {{intern_property("color"), {{2}}}} },
+            };
+            RecordStore store(records);
+            InvertedIndex index(store);
+            PropertyId color = intern_property("color");
+
+            Assert::AreEqual(size_t(3), index.recordCount());
+            Assert::IsTrue(ids(index.withProperty(color)) == vector<uint32_t>{ 0, 2 });
+            Assert::IsTrue(ids(index.withValue(color, 2)) == vector<uint32_t>{ 0, 2 });
+            Assert::IsTrue(ids(index.withValue(color, 1)) == vector<uint32_t>{ 0 });
+            Assert::IsTrue(index.withValue(color, 3).empty());
+            Assert::IsTrue(ids(index.withProperty(intern_property("height"))) == vector<uint32_t>{ 1 });
+            Assert::IsTrue(index.withProperty(intern_property("index-test-unused")).empty());
+        }
+
+        TEST_METHOD(Intersect_ShortWithLong)
+        {
+            vector<uint32_t> longList;
+            for (uint32_t i = 0; i < 1000; i += 3) longList.push_back(i);
+            PostingList a{ 0, 1, 3, 500, 501, 999, 1200 };
+            intersect_postings(a, { longList.data(), longList.size() });
+            Assert::IsTrue(a == PostingList{ 0, 3, 501, 999 });
+
+            PostingList none{ 5, 7 };
+            intersect_postings(none, {});
+            Assert::IsTrue(none.empty());
+        }
+
+        TEST_METHOD(Classify_MatchesScan)
+        {
+            vector<Record> records;
+            for (int i = 0; i < 500; i++) {
+                IntList colors{ i % 4, (i / 4) % 4 }, size{ i % 3 };
+                records.push_back(Record{ "R" + to_string(i), {
+                    {intern_property("color"), {colors}},
+                    {intern_property(i % 5 ? "size" : "weight"), {size}} } });
+            }
+            vector<ClassRule> classes = {
+                { "Red", { Rule{ CONTAINS_VALUE, "color", 0, 2, {} } } },
+                { "RedBlue", { Rule{ CONTAINS_VALUE, "color", 0, 2, {} }, Rule{ CONTAINS_VALUE, "color", 0, 3, {} } } },
+                { "Sized", { Rule{ HAS_PROPERTY, "size", 0, 0, {} }, Rule{ PROPERTY_SIZE, "color", 2, 0, {} } } },
+                { "Exact", { Rule{ EQUALS_EXACTLY, "color", 0, 0, {1, 3} }, Rule{ CONTAINS_VALUE, "weight", 0, 0, {} } } },
+                { "Red", { Rule{ EQUALS_EXACTLY, "size", 0, 0, {2} } } },
+                { "Nothing", { Rule{ CONTAINS_VALUE, "color", 0, 9, {} } } },
+                { "Unknown", { Rule{ HAS_PROPERTY, "index-test-unused", 0, 0, {} } } },
+                { "Everything", {} },
+            };
+
+            for (ValueStorage storage : { ValueStorage::PLAIN, ValueStorage::PACKED }) {
+                RecordStore store(records, storage);
+                InvertedIndex index(store);
+                Assert::IsTrue(classify(store, classes) == classify(store, index, classes));
+                Assert::IsTrue(classify(store, classes) == classify_bitmaps(store, index, classes));
+
+                ThreadPool pool(3);
+                Assert::IsTrue(classify(store, classes) == classify(store, index, classes, pool));
+                Assert::IsTrue(classify(store, classes) == classify_bitmaps(store, index, classes, pool));
+
+                InvertedIndex scoped(store, classes);
+                Assert::IsTrue(classify(store, classes) == classify(store, scoped, classes));
+                Assert::IsTrue(classify(store, classes) == classify_bitmaps(store, scoped, classes, pool));
+            }
+        }
+
+        TEST_METHOD(RuleIndex_CoversOnlyRuleProperties)
+        {
+            vector<Record> records;
+            for (int i = 0; i < 10; i++)
+                records.push_back(Record{ "R" + to_string(i), {
+                    {intern_property("color"), {{i % 3}}}, {intern_property("size"), {{i}}} } });
+            RecordStore store(records);
+            vector<ClassRule> classes = {
+                { "Red", { Rule{ CONTAINS_VALUE, "color", 0, 2, {} } } },
+                { "Exact", { Rule{ EQUALS_EXACTLY, "color", 0, 0, {1} } } },
+            };
+
+            InvertedIndex index(store, classes);
+            Assert::AreEqual(size_t(3), index.withValue(intern_property("color"), 2).size());
+            Assert::AreEqual(size_t(10), index.withProperty(intern_property("color")).size());
+            Assert::IsTrue(index.withValue(intern_property("color"), 1).empty());
+            Assert::IsTrue(index.withProperty(intern_property("size")).empty());
+            Assert::IsTrue(classify(store, classes) == classify_bitmaps(store, index, classes));
+        }
+    };
+}
@@ -0,0 +1,82 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include "../PackedInts.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: PackedIntsTests
+ * ---------------------------
+ * Tests frame-of-reference bit packing: the chosen width, reading back
+ * every value, and searching ranges that start and end inside words.
+ */
+
+namespace PackedIntsTests
+{
+    TEST_CLASS(PackedIntsTests)
+    {
+    public:
+
+        // Checks every accessor of p against the plain values
+        static void checkAgainst(const PackedInts& p, const vector<int>& values)
+        {
+            Assert::AreEqual(values.size(), p.size());
+            vector<int> decoded(values.size());
+            p.decode(0, values.size(), decoded.data());
+            Assert::IsTrue(decoded == values);
+
+            for (size_t first = 0; first < values.size(); first += 7) {
+                for (size_t last = first; last <= values.size() && last < first + 40; last += 3) {
+                    for (int probe : { values[first], values[last - (last > first)], values[0] + 1, INT_MIN, INT_MAX }) {
+                        bool expected = find(values.begin() + first, values.begin() + last, probe) != values.begin() + last;
+                        Assert::AreEqual(expected, p.contains(first, last, probe));
+                    }
+                    Assert::IsTrue(p.equals(first, last, values.data() + first, last - first));
+                }
+            }
+        }
+
+        TEST_METHOD(Widths_RoundToPowerOfTwo)
+        {
+            Assert::AreEqual(0u, PackedInts(vector<int>{ 7, 7, 7 }).width());
+            Assert::AreEqual(2u, PackedInts(vector<int>{ 100, 103, 101 }).width());
+            Assert::AreEqual(8u, PackedInts(vector<int>{ -10, 200 }).width());
+            Assert::AreEqual(32u, PackedInts(vector<int>{ INT_MIN, INT_MAX }).width());
+            Assert::AreEqual(-10, PackedInts(vector<int>{ -10, 200 }).base());
+        }
+
+        TEST_METHOD(RoundTrip_AllWidths)
+        {
+            for (int range : { 1, 2, 3, 15, 200, 60000, 1 << 20 }) {
+                vector<int> values;
+                for (int i = 0; i < 300; i++)
+                    values.push_back(-5 + (i * 7919) % (range + 1));
+                checkAgainst(PackedInts(values), values);
+            }
+            vector<int> extremes{ INT_MIN, INT_MAX, 0, -1, INT_MIN, 42 };
+            checkAgainst(PackedInts(extremes), extremes);
+        }
+
+        TEST_METHOD(Equals_DetectsDifferences)
+        {
+            vector<int> values{ 1, 2, 3, 4 };
+            PackedInts p(values);
+            int other[] = { 1, 2, 4 };
+            Assert::IsFalse(p.equals(0, 3, other, 3));
+            Assert::IsFalse(p.equals(0, 3, values.data(), 4));
+            Assert::IsTrue(p.equals(2, 2, nullptr, 0));
+        }
+
+        TEST_METHOD(Empty)
+        {
+            PackedInts p(vector<int>{});
+            Assert::AreEqual(size_t(0), p.size());
+            Assert::AreEqual(size_t(0), p.bytes());
+            Assert::IsFalse(p.contains(0, 0, 0));
+        }
+    };
+}
@@ -219,5 +219,111 @@ namespace ParseClassLineTests
             Assert::AreEqual(size_t(0), errors.size());
             Assert::AreEqual("Green"s, rule.className);
         }
+        // 17. Russian keywords
+        TEST_METHOD(RussianKeywords_ShouldParse)
+        {
+            ClassRule a, b, c, d;
+            std::set<Error> errors;
+
+            Assert::IsTrue(parse_class_line("Покрытие: есть свойство \"coating\"", a, errors));
+            Assert::IsTrue(parse_class_line("Объёмный: свойство \"size\" имеет 3 значений", b, errors));
+            Assert::IsTrue(parse_class_line("Синий: свойство \"color\" содержит значение 1", c, errors));
+            Assert::IsTrue(parse_class_line("Матовый: свойство \"coating\" = [44; 21]", d, errors));
+
+            Assert::AreEqual(size_t(0), errors.size());
+            Assert::AreEqual((int)RuleType::HAS_PROPERTY, (int)a.rules[0].type);
+            Assert::AreEqual(3, b.rules[0].expectedSize);
+            Assert::AreEqual(1, c.rules[0].expectedValue);
+            Assert::AreEqual(2, (int)d.rules[0].expectedExactValues.size());
+        }
+
+        // 18. Digits in the property name do not leak into the value count
+        TEST_METHOD(DigitsInPropertyName_ShouldNotAffectSize)
+        {
+            ClassRule rule;
+            std::set<Error> errors;
+            bool ok = parse_class_line("Wide: property \"size2d\" has 4 values", rule, errors);
+
+            Assert::IsTrue(ok);
+            Assert::AreEqual("size2d"s, rule.rules[0].propertyName);
+            Assert::AreEqual(4, rule.rules[0].expectedSize);
+        }
+
+        // 19. Trailing text after a complete rule
+        TEST_METHOD(TrailingGarbage_ShouldFail)
+        {
+            ClassRule rule;
+            std::set<Error> errors;
+            bool ok = parse_class_line("Blue: property \"color\" contains value 1 2", rule, errors);
+
+            Assert::IsFalse(ok);
+            Assert::AreEqual(size_t(1), errors.size());
+            Assert::AreEqual((int)ErrorCode::SYNTAX_ERROR_IN_CLASS_RULE, (int)errors.begin()->code);
+            Assert::AreEqual(size_t(41), errors.begin()->column);
+        }
+
+        // 20. Error column points at the offending token
+        TEST_METHOD(ErrorColumn_PointsAtToken)
+        {
+            ClassRule rule;
+            std::set<Error> errors;
+            bool ok = parse_class_line("Blue: property \"color\" contains value X", rule, errors);
+
+            Assert::IsFalse(ok);
+            Assert::AreEqual((int)ErrorCode::INVALID_NUMERIC_VALUE, (int)errors.begin()->code);
+            Assert::AreEqual(size_t(39), errors.begin()->column);
+        }
+
+        // 21. Unterminated list
+        TEST_METHOD(UnterminatedList_ShouldFail)
+        {
+            ClassRule rule;
+            std::set<Error> errors;
+            bool ok = parse_class_line("Matte: property \"coating\" = [44, 21", rule, errors);
+
+            Assert::IsFalse(ok);
+            Assert::AreEqual((int)ErrorCode::INCORRECT_RULE, (int)errors.begin()->code);
+        }
+
+        // 22. Signed operands are rejected outside of '=' lists
+        TEST_METHOD(SignedOperand_ShouldFail)
+        {
+            const char* lines[] = {
+                "Neg: property \"color\" contains value -1",
+                "Pos: property \"color\" contains value +1",
+                "Size: property \"size\" has +2 values",
+            };
+            for (const char* line : lines) {
+                ClassRule rule;
+                std::set<Error> errors;
+                Assert::IsFalse(parse_class_line(line, rule, errors));
+                Assert::AreEqual((int)ErrorCode::INVALID_NUMERIC_VALUE, (int)errors.begin()->code);
+            }
+
+            ClassRule list;
+            std::set<Error> errors;
+            Assert::IsTrue(parse_class_line("List: property \"t\" = [-1, +2]", list, errors));
+            Assert::AreEqual(-1, list.rules[0].expectedExactValues[0]);
+        }
+
+        // 23. The size is always followed by the plural "values"
+        TEST_METHOD(SingularValue_ShouldFail)
+        {
+            const char* lines[] = {
+                "One: property \"size\" has 1 value",
+                "Один: свойство \"size\" имеет 1 значение",
+            };
+            for (const char* line : lines) {
+                ClassRule rule;
+                std::set<Error> errors;
+                Assert::IsFalse(parse_class_line(line, rule, errors));
+                Assert::AreEqual((int)ErrorCode::UNKNOWN_RULE_TYPE, (int)errors.begin()->code);
+            }
+
+            ClassRule rule;
+            std::set<Error> errors;
+            Assert::IsTrue(parse_class_line("One: property \"size\" has 1 values", rule, errors));
+            Assert::IsTrue(parse_class_line("Один: свойство \"size\" имеет 1 значения", rule, errors));
+        }
     };
 }
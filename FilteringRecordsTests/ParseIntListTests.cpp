@@ -0,0 +1,101 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <vector>
+#include <climits>
+#include "../Parser.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: ParseIntListTests
+ * -----------------------------
+ * Tests the integer list scanner used for property values and
+ * EQUALS_EXACTLY rules: separators, signs, malformed tokens, int range
+ * limits and appending into a caller-provided buffer.
+ */
+
+namespace ParseIntListTests
+{
+    TEST_CLASS(ParseIntListTests)
+    {
+    public:
+
+        TEST_METHOD(CommaSeparated_ShouldParse)
+        {
+            IntList v = parseIntList("1, 4, 20");
+            Assert::IsTrue(v == IntList{ 1, 4, 20 });
+        }
+
+        TEST_METHOD(MixedSeparators_ShouldParse)
+        {
+            IntList v = parseIntList("10; 20 ,30\t40");
+            Assert::IsTrue(v == IntList{ 10, 20, 30, 40 });
+        }
+
+        TEST_METHOD(Signs_ShouldParse)
+        {
+            IntList v = parseIntList("-5, +7, -0");
+            Assert::IsTrue(v == IntList{ -5, 7, 0 });
+        }
+
+        TEST_METHOD(IntLimits_ShouldParse)
+        {
+            IntList v = parseIntList("2147483647, -2147483648");
+            Assert::AreEqual(2147483647, v[0]);
+            Assert::IsTrue(v[1] == INT_MIN);
+        }
+
+        TEST_METHOD(Overflow_ShouldFail)
+        {
+            vector<int> v;
+            Assert::IsTrue(IntListStatus::OUT_OF_RANGE == parseIntListInto("1, 2147483648", v));
+            Assert::IsTrue(IntListStatus::OUT_OF_RANGE == parseIntListInto("-2147483649", v));
+            Assert::IsTrue(v.empty());
+        }
+
+        TEST_METHOD(Garbage_ShouldFail)
+        {
+            vector<int> v;
+            Assert::IsTrue(IntListStatus::INVALID_TOKEN == parseIntListInto("1, a, 3", v));
+            Assert::IsTrue(IntListStatus::INVALID_TOKEN == parseIntListInto("12x", v));
+            Assert::IsTrue(IntListStatus::INVALID_TOKEN == parseIntListInto("-", v));
+            Assert::IsTrue(IntListStatus::INVALID_TOKEN == parseIntListInto("[1]", v));
+            Assert::IsTrue(parseIntList("1, a, 3").empty());
+        }
+
+        TEST_METHOD(EmptyTokens_AreSkipped)
+        {
+            vector<int> v;
+            Assert::IsTrue(IntListStatus::OK == parseIntListInto("1,,2,", v));
+            Assert::IsTrue(v == vector<int>{ 1, 2 });
+            Assert::IsTrue(IntListStatus::OK == parseIntListInto("", v));
+        }
+
+        TEST_METHOD(AppendsToBuffer_AndRollsBackOnFailure)
+        {
+            vector<int> v{ 9 };
+            Assert::IsTrue(IntListStatus::OK == parseIntListInto("1, 2", v));
+            Assert::IsTrue(v == vector<int>{ 9, 1, 2 });
+            Assert::IsTrue(IntListStatus::INVALID_TOKEN == parseIntListInto("3, x", v));
+            Assert::IsTrue(v == vector<int>{ 9, 1, 2 });
+        }
+
+        TEST_METHOD(ShortList_StaysInline)
+        {
+            IntList v = parseIntList("20, 40");
+            Assert::IsTrue(v.isInline());
+            Assert::IsTrue(v == IntList{ 20, 40 });
+        }
+
+        TEST_METHOD(LongList_SpillsToHeap_AndRollsBackOnFailure)
+        {
+            IntList v{ 9 };
+            Assert::IsTrue(IntListStatus::OK == parseIntListInto("1, 2, 3, 4, 5, 6", v));
+            Assert::IsFalse(v.isInline());
+            Assert::IsTrue(v == IntList{ 9, 1, 2, 3, 4, 5, 6 });
+            Assert::IsTrue(IntListStatus::INVALID_TOKEN == parseIntListInto("7, 8, 9, x", v));
+            Assert::IsTrue(v == IntList{ 9, 1, 2, 3, 4, 5, 6 });
+        }
+    };
+}
@@ -21,11 +21,11 @@ namespace ParseRecordLineTests
             bool ok = parse_record_line("Wardrobe: color = [1, 2], size = [10, 20]", r, errors);
 
             Assert::IsTrue(ok);
-            Assert::AreEqual(std::string("Wardrobe"), r.name);
+            Assert::AreEqual(std::string("Wardrobe"), std::string(r.name));
             Assert::AreEqual(size_t(2), r.properties.size());
             Assert::IsNotNull(r.getProperty("color"));
             Assert::IsNotNull(r.getProperty("size"));
-            Assert::AreEqual(2, (int)r.getProperty("color")->values.size());
+            Assert::AreEqual(2, (int)r.valuesOf(*r.getProperty("color")).size());
         }
 
         // 2. Некорректное значение
@@ -89,7 +89,7 @@ namespace ParseRecordLineTests
             std::set<Error> errors;
             bool ok = parse_record_line("Lamp: power=[100]", r, errors);
             Assert::IsTrue(ok);
-            Assert::AreEqual(std::string("Lamp"), r.name);
+            Assert::AreEqual(std::string("Lamp"), std::string(r.name));
             Assert::IsNotNull(r.getProperty("power"));
         }
 
@@ -100,9 +100,9 @@ namespace ParseRecordLineTests
             std::set<Error> errors;
             bool ok = parse_record_line("   Sofa   : color = [ 5 ]", r, errors);
             Assert::IsTrue(ok);
-            Assert::AreEqual(std::string("Sofa"), r.name);
+            Assert::AreEqual(std::string("Sofa"), std::string(r.name));
             Assert::IsNotNull(r.getProperty("color"));
-            Assert::AreEqual(1, (int)r.getProperty("color")->values.size());
+            Assert::AreEqual(1, (int)r.valuesOf(*r.getProperty("color")).size());
         }
 
         // 10. Пробелы вокруг значений
@@ -112,8 +112,8 @@ namespace ParseRecordLineTests
             std::set<Error> errors;
             bool ok = parse_record_line("Box: length = [  50  ]", r, errors);
             Assert::IsTrue(ok);
-            Assert::AreEqual(1, (int)r.getProperty("length")->values.size());
-            Assert::AreEqual(50, r.getProperty("length")->values[0]);
+            Assert::AreEqual(1, (int)r.valuesOf(*r.getProperty("length")).size());
+            Assert::AreEqual(50, r.valuesOf(*r.getProperty("length"))[0]);
         }
 
         // 11. Очень много свойств (stress test)
@@ -157,7 +157,7 @@ namespace ParseRecordLineTests
             bool ok = parse_record_line("Shelf: height = []", r, errors);
             Assert::IsTrue(ok);
             Assert::IsNotNull(r.getProperty("height"));
-            Assert::AreEqual((int)0, (int)r.getProperty("height")->values.size());
+            Assert::AreEqual((int)0, (int)r.valuesOf(*r.getProperty("height")).size());
         }
 
         // 15. Отрицательные значения
@@ -168,8 +168,51 @@ namespace ParseRecordLineTests
             bool ok = parse_record_line("Desk: width=[-5, -10]", r, errors);
             Assert::IsTrue(ok);
             Assert::IsNotNull(r.getProperty("width"));
-            Assert::AreEqual(2, (int)r.getProperty("width")->values.size());
-            Assert::AreEqual(-5, r.getProperty("width")->values[0]);
+            Assert::AreEqual(2, (int)r.valuesOf(*r.getProperty("width")).size());
+            Assert::AreEqual(-5, r.valuesOf(*r.getProperty("width"))[0]);
+        }
+
+        // 16. Разбор строки внутри большего буфера (string_view)
+        TEST_METHOD(LineInsideBuffer_ShouldParse)
+        {
+            std::string buffer = "Desk: width=[5, 10]\nLamp: power=[100]\n";
+            std::string_view line(buffer.data(), buffer.find('\n'));
+            Record r;
+            std::set<Error> errors;
+            bool ok = parse_record_line(line, r, errors);
+            Assert::IsTrue(ok);
+            Assert::AreEqual(std::string("Desk"), std::string(r.name));
+            Assert::AreEqual(size_t(1), r.properties.size());
+            Assert::AreEqual(10, r.valuesOf(*r.getProperty("width"))[1]);
+        }
+
+        // 17. Параллельный разбор сохраняет порядок записей и ошибок
+        TEST_METHOD(ParseRecords_ParallelKeepsOrder)
+        {
+            std::string text;
+            for (int i = 0; i < 40000; i++) {
+                text += "Item" + std::to_string(i) + ": color = [" + std::to_string(i % 7) + "]\n";
+                if (i % 1000 == 0) text += "Broken" + std::to_string(i) + " color = [1]\n";
+            }
+
+            std::vector<Record> seq, par;
+            ErrorSink seqErrors, parErrors;
+            std::vector<std::string_view> seqRejected, parRejected;
+            parse_records(text, seq, seqErrors, seqRejected, 1);
+            parse_records(text, par, parErrors, parRejected, 4);
+
+            Assert::AreEqual(size_t(40000), par.size());
+            Assert::AreEqual(seq.size(), par.size());
+            for (size_t i = 0; i < seq.size(); i++)
+                Assert::AreEqual(std::string(seq[i].name), std::string(par[i].name));
+            Assert::IsTrue(seqRejected == parRejected);
+            Assert::AreEqual(size_t(40), parRejected.size());
+            Assert::AreEqual(size_t(40), parErrors.count(ErrorCode::INVALID_RECORD));
+            Assert::AreEqual(seqErrors.examples().size(), parErrors.examples().size());
+            for (size_t i = 0; i < seqErrors.examples().size(); i++)
+                Assert::AreEqual(seqErrors.examples()[i].line, parErrors.examples()[i].line);
+            Assert::AreEqual(size_t(2), parErrors.examples()[0].line);
+            Assert::AreEqual(size_t(1003), parErrors.examples()[1].line);
         }
     };
 }
@@ -0,0 +1,74 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <algorithm>
+#include <vector>
+#include "../RecordBitmap.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: RecordBitmapTests
+ * -----------------------------
+ * Tests the compressed record bitmap with sparse and dense containers:
+ * building, membership, iteration order and intersection.
+ */
+
+namespace RecordBitmapTests
+{
+    TEST_CLASS(RecordBitmapTests)
+    {
+    public:
+
+        static vector<uint32_t> ids(const RecordBitmap& b)
+        {
+            vector<uint32_t> out;
+            b.forEach([&](uint32_t id) { out.push_back(id); });
+            return out;
+        }
+
+        // Every step-th id below limit, starting at first
+        static vector<uint32_t> every(uint32_t first, uint32_t step, uint32_t limit)
+        {
+            vector<uint32_t> out;
+            for (uint32_t id = first; id < limit; id += step) out.push_back(id);
+            return out;
+        }
+
+        TEST_METHOD(Build_SparseAndDense_ReadsBack)
+        {
+            vector<uint32_t> sparse = every(5, 1000, 300000), dense = every(0, 3, 200000);
+            RecordBitmap a = RecordBitmap::fromSorted(sparse.data(), sparse.size());
+            RecordBitmap b = RecordBitmap::fromSorted(dense.data(), dense.size());
+
+            Assert::IsTrue(ids(a) == sparse);
+            Assert::IsTrue(ids(b) == dense);
+            Assert::AreEqual(dense.size(), b.cardinality());
+            Assert::IsTrue(b.contains(199998));
+            Assert::IsFalse(b.contains(199999));
+            Assert::IsFalse(a.contains(6));
+        }
+
+        TEST_METHOD(Intersect_AllContainerKinds)
+        {
+            vector<uint32_t> lists[] = { every(0, 2, 150000), every(0, 3, 150000), every(7, 500, 150000), every(65536, 1, 65600) };
+            for (const auto& x : lists) {
+                for (const auto& y : lists) {
+                    RecordBitmap a = RecordBitmap::fromSorted(x.data(), x.size());
+                    a &= RecordBitmap::fromSorted(y.data(), y.size());
+                    vector<uint32_t> expected;
+                    set_intersection(x.begin(), x.end(), y.begin(), y.end(), back_inserter(expected));
+                    Assert::IsTrue(ids(a) == expected);
+                    Assert::AreEqual(expected.size(), a.cardinality());
+                }
+            }
+        }
+
+        TEST_METHOD(Range_HoldsAllIds)
+        {
+            Assert::IsTrue(ids(RecordBitmap::range(70000)) == every(0, 1, 70000));
+            Assert::IsTrue(ids(RecordBitmap::range(10)) == every(0, 1, 10));
+            Assert::IsTrue(RecordBitmap::range(0).empty());
+        }
+    };
+}
@@ -0,0 +1,129 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "../RecordSnapshot.h"
+#include "../InputFile.h"
+#include "../Classifier.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: RecordSnapshotTests
+ * -------------------------------
+ * Tests the binary items snapshot: records written with
+ * write_record_snapshot must load back unchanged and classify exactly
+ * like the parsed records.
+ */
+
+namespace RecordSnapshotTests
+{
+    TEST_CLASS(RecordSnapshotTests)
+    {
+    public:
+
+        static vector<Record> sampleRecords()
+        {
+            return {
+                Record{ "Wardrobe", {{intern_property("color"), {{1, 2}}}, {intern_property("size"), {{10, 40, 60}}}} },
+                Record{ "Lamp", {} },
+                Record{ "Table", {{intern_property("color"), {{2}}}, {intern_property("coating"), {{44, 21}}}} },
+            };
+        }
+
+        TEST_METHOD(WriteAndLoad_RoundTrip)
+        {
+            vector<Record> records = sampleRecords();
+            Assert::IsTrue(write_record_snapshot("test_items.snap", records));
+
+            InputFile in;
+            RecordSnapshot snapshot;
+            Assert::IsTrue(in.open("test_items.snap"));
+            Assert::IsTrue(is_record_snapshot(in.data()));
+            Assert::IsTrue(snapshot.load(in.data()));
+            Assert::AreEqual(size_t(3), snapshot.size());
+
+            for (size_t i = 0; i < records.size(); i++) {
+                Record rec = snapshot.toRecord(i);
+                Assert::AreEqual(string(records[i].name), string(rec.name));
+                Assert::AreEqual(records[i].properties.size(), rec.properties.size());
+                for (const auto& entry : records[i].properties) {
+                    PropertyValues expected = records[i].valuesOf(entry);
+                    PropertyValues actual = rec.valuesOf(*rec.getProperty(entry.id));
+                    Assert::IsTrue(equal(expected.begin(), expected.end(), actual.begin(), actual.end()));
+                }
+            }
+
+            in.close();
+            remove("test_items.snap");
+        }
+
+        TEST_METHOD(FindProperty_ByInternedName)
+        {
+            Assert::IsTrue(write_record_snapshot("test_items.snap", sampleRecords()));
+            InputFile in;
+            RecordSnapshot snapshot;
+            Assert::IsTrue(in.open("test_items.snap") && snapshot.load(in.data()));
+
+            int color = snapshot.findName("color");
+            const int* values = nullptr;
+            size_t count = 0;
+            Assert::IsTrue(color >= 0);
+            Assert::AreEqual(-1, snapshot.findName("weight"));
+            Assert::IsTrue(snapshot.findProperty(2, color, values, count));
+            Assert::AreEqual(size_t(1), count);
+            Assert::AreEqual(2, values[0]);
+            Assert::IsFalse(snapshot.findProperty(1, color, values, count));
+
+            in.close();
+            remove("test_items.snap");
+        }
+
+        TEST_METHOD(ClassifySnapshot_MatchesClassify)
+        {
+            vector<Record> records = sampleRecords();
+            vector<ClassRule> classes = {
+                { "Colored", { Rule{ HAS_PROPERTY, "color", 0, 0, {} } } },
+                { "Red", { Rule{ CONTAINS_VALUE, "color", 0, 2, {} } } },
+                { "Matte", { Rule{ EQUALS_EXACTLY, "coating", 0, 0, {44, 21} } } },
+                { "Heavy", { Rule{ HAS_PROPERTY, "weight", 0, 0, {} } } },
+            };
+            Assert::IsTrue(write_record_snapshot("test_items.snap", records));
+            InputFile in;
+            RecordSnapshot snapshot;
+            Assert::IsTrue(in.open("test_items.snap") && snapshot.load(in.data()));
+
+            Assert::IsTrue(classify(records, classes) == classify_snapshot(snapshot, classes));
+
+            // A store built from the snapshot serves every engine
+            for (ValueStorage storage : { ValueStorage::PLAIN, ValueStorage::PACKED }) {
+                RecordStore store(snapshot, storage);
+                Assert::AreEqual(records.size(), store.size());
+                Assert::IsTrue(classify(records, classes) == classify(store, RuleTable(classes), classes));
+                Assert::IsTrue(classify(records, classes) == classify_bitmaps(store, InvertedIndex(store, classes), classes));
+            }
+
+            in.close();
+            remove("test_items.snap");
+        }
+
+        TEST_METHOD(Load_TruncatedSnapshot_ShouldFail)
+        {
+            Assert::IsTrue(write_record_snapshot("test_items.snap", sampleRecords()));
+            string bytes;
+            {
+                InputFile in;
+                Assert::IsTrue(in.open("test_items.snap"));
+                bytes.assign(in.data().substr(0, in.data().size() - 8));
+            }
+            remove("test_items.snap");
+
+            RecordSnapshot snapshot;
+            Assert::IsFalse(snapshot.load(bytes));
+            Assert::IsFalse(snapshot.load("Car: color = [1]"));
+        }
+    };
+}
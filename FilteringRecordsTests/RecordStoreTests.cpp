@@ -0,0 +1,144 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <algorithm>
+#include <string>
+#include "../RecordStore.h"
+#include "../Classifier.h"
+#include "../Matching.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: RecordStoreTests
+ * ----------------------------
+ * Tests the columnar record store: every record must read back
+ * unchanged through its columns and classify exactly like the records
+ * it was built from, whatever value layout inference picks.
+ */
+
+namespace RecordStoreTests
+{
+    TEST_CLASS(RecordStoreTests)
+    {
+    public:
+
+        static vector<Record> sampleRecords()
+        {
+            vector<Record> records = {
+                Record{ "Wardrobe", {{intern_property("color"), {{1, 2}}}, {intern_property("size"), {{10, 40, 60}}}} },
+                Record{ "Lamp", {{intern_property("height"), {{}}}} },
+                Record{ "Table", {{intern_property("color"), {{2}}}, {intern_property("coating"), {{44, 21}}}} },
+            };
+            // Enough records to span several presence words
+            for (int i = 0; i < 150; i++)
+                records.push_back(Record{ "Chair" + to_string(i), {{intern_property("color"), {{i % 3}}}} });
+            return records;
+        }
+
+        TEST_METHOD(Build_ColumnsMatchRecords)
+        {
+            vector<Record> records = sampleRecords();
+            RecordStore store(records);
+
+            Assert::AreEqual(records.size(), store.size());
+            for (size_t r = 0; r < records.size(); r++) {
+                Assert::AreEqual(string(records[r].name), string(store.name(r)));
+                for (const auto& entry : records[r].properties) {
+                    const PropertyColumn* column = store.column(entry.id);
+                    Assert::IsNotNull(column);
+                    Assert::IsTrue(column->has(r));
+                    PropertyValues expected = records[r].valuesOf(entry), actual = column->values(r);
+                    Assert::IsTrue(equal(expected.begin(), expected.end(), actual.begin(), actual.end()));
+                }
+            }
+
+            const PropertyColumn* coating = store.column(intern_property("coating"));
+            Assert::IsFalse(coating->has(0));
+            Assert::IsTrue(coating->has(2));
+            Assert::IsTrue(coating->values(100).empty());
+            Assert::IsTrue(store.column(intern_property("height"))->has(1));
+            Assert::IsNull(store.column(intern_property("store-test-unused")));
+        }
+
+        TEST_METHOD(Classify_MatchesRecords)
+        {
+            vector<Record> records = sampleRecords();
+            vector<ClassRule> classes = {
+                { "Colored", { Rule{ HAS_PROPERTY, "color", 0, 0, {} } } },
+                { "Red", { Rule{ CONTAINS_VALUE, "Color", 0, 2, {} } } },
+                { "Matte", { Rule{ EQUALS_EXACTLY, "coating", 0, 0, {44, 21} } } },
+                { "Flat", { Rule{ PROPERTY_SIZE, "height", 0, 0, {} } } },
+                { "Heavy", { Rule{ HAS_PROPERTY, "weight", 0, 0, {} } } },
+            };
+
+            Assert::IsTrue(classify(records, classes) == classify(RecordStore(records), classes));
+            Assert::IsTrue(classify(records, classes) == classify(RecordStore(records, ValueStorage::PACKED), classes));
+        }
+
+        TEST_METHOD(Packed_ReadsBackAndShrinks)
+        {
+            vector<Record> records = sampleRecords();
+            RecordStore plain(records), packed(records, ValueStorage::PACKED);
+
+            const PropertyColumn* color = packed.column(intern_property("color"));
+            Assert::IsTrue(color->layout() == ValueLayout::PACKED);
+            IntList values;
+            for (size_t r = 0; r < records.size(); r++) {
+                for (const auto& entry : records[r].properties) {
+                    packed.column(entry.id)->readValues(r, values);
+                    PropertyValues expected = records[r].valuesOf(entry);
+                    Assert::IsTrue(equal(expected.begin(), expected.end(), values.begin(), values.end()));
+                }
+            }
+            Assert::IsTrue(packed.valueBytes() * 4 <= plain.valueBytes());
+            Assert::IsTrue(packed.indexBytes() * 4 <= plain.indexBytes());
+
+            // Offsets are packed per block of 64 records
+            for (size_t r = 0; r <= records.size(); r++)
+                Assert::AreEqual(plain.column(intern_property("color"))->offset(r), color->offset(r));
+            Assert::AreEqual(uint64_t(153), color->valueCount());
+            Assert::IsTrue(color->offsets().empty() && color->data().empty());
+        }
+
+        TEST_METHOD(InferLayout_PicksLayoutByShape)
+        {
+            vector<Record> records;
+            for (int i = 0; i < 100; i++) {
+                IntList tags, codes;
+                for (int k = 0; k < 20; k++) tags.push_back((i * 7919 + k * 104729) % 100000 - 50000);
+                codes.push_back(i % 5);
+                codes.push_back(i % 3 + 60);
+                records.push_back(Record{ "R" + to_string(i), {
+                    {intern_property("layout-id"), {{i * 1000}}},
+                    {intern_property("layout-codes"), {codes}},
+                    {intern_property("layout-tags"), {tags}},
+                    {intern_property("layout-pair"), {{i, i * 1000}}} } });
+            }
+            RecordStore store(records);
+
+            Assert::IsTrue(store.column(intern_property("layout-id"))->layout() == ValueLayout::SCALAR);
+            Assert::IsTrue(store.column(intern_property("layout-codes"))->layout() == ValueLayout::BITSET);
+            Assert::IsTrue(store.column(intern_property("layout-tags"))->layout() == ValueLayout::SORTED);
+            Assert::IsTrue(store.column(intern_property("layout-pair"))->layout() == ValueLayout::LISTS);
+
+            // Every layout answers like a scan of the record's values
+            for (const auto& entry : records[0].properties) {
+                const PropertyColumn* column = store.column(entry.id);
+                for (size_t r = 0; r < records.size(); r++) {
+                    PropertyValues values = records[r].valuesOf(*records[r].getProperty(entry.id));
+                    for (int probe : { -50000, -1, 0, 2, 61, 63, 64, 5000, 99000, values[0], values[values.size() - 1] })
+                        Assert::AreEqual(find(values.begin(), values.end(), probe) != values.end(),
+                            column->contains(r, probe));
+                }
+            }
+        }
+
+        TEST_METHOD(Build_Empty)
+        {
+            RecordStore store{ vector<Record>() };
+            Assert::AreEqual(size_t(0), store.size());
+            Assert::IsNull(store.column(intern_property("color")));
+        }
+    };
+}
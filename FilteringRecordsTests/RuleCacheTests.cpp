@@ -0,0 +1,105 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <cstdio>
+#include <string>
+#include "../RuleCache.h"
+#include "../InputFile.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: RuleCacheTests
+ * --------------------------
+ * Tests the compiled ruleset cache: a cache must restore exactly what
+ * parse_rules produces for the same text and must be rejected as soon
+ * as the text changes.
+ */
+
+namespace RuleCacheTests
+{
+    TEST_CLASS(RuleCacheTests)
+    {
+    public:
+
+        static bool sameRules(const vector<ClassRule>& a, const vector<ClassRule>& b)
+        {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); i++) {
+                if (a[i].className != b[i].className || a[i].rules.size() != b[i].rules.size())
+                    return false;
+                for (size_t j = 0; j < a[i].rules.size(); j++) {
+                    const Rule& x = a[i].rules[j];
+                    const Rule& y = b[i].rules[j];
+                    if (x.type != y.type || x.propertyName != y.propertyName ||
+                        x.expectedSize != y.expectedSize || x.expectedValue != y.expectedValue ||
+                        x.expectedExactValues != y.expectedExactValues)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        TEST_METHOD(WriteAndLoad_RestoresParsedRules)
+        {
+            string text =
+                "Blue: property \"color\" contains value 1\n"
+                "Broken: property color contains value 1\n"
+                "\n"
+                "Matte: property \"coating\" = [44, 21]\n"
+                "Large: property \"size\" has 3 values\n";
+            vector<ClassRule> parsed;
+            ErrorSink parseErrors;
+            vector<RuleDiagnostic> parseRejected;
+            parse_rules(text, parsed, parseErrors, parseRejected);
+            Assert::IsTrue(write_rule_cache("test_rules.cache", text, parsed, parseRejected));
+
+            InputFile cache;
+            vector<ClassRule> loaded;
+            ErrorSink errors;
+            vector<RuleDiagnostic> rejected;
+            Assert::IsTrue(cache.open("test_rules.cache"));
+            Assert::IsTrue(load_rule_cache(cache.data(), text, loaded, errors, rejected));
+
+            Assert::IsTrue(sameRules(parsed, loaded));
+            Assert::AreEqual(size_t(1), rejected.size());
+            Assert::AreEqual(size_t(2), rejected[0].line);
+            Assert::AreEqual(parseRejected[0].column, rejected[0].column);
+            Assert::AreEqual(string(parseRejected[0].text), string(rejected[0].text));
+            Assert::AreEqual(size_t(1), errors.total());
+            Assert::AreEqual(size_t(1), errors.count(ErrorCode::MISSING_QUOTE));
+            Assert::AreEqual(size_t(2), errors.examples()[0].line);
+
+            cache.close();
+            remove("test_rules.cache");
+        }
+
+        TEST_METHOD(Load_ChangedSource_ShouldFail)
+        {
+            string text = "Blue: property \"color\" contains value 1\n";
+            vector<ClassRule> parsed;
+            ErrorSink errors;
+            vector<RuleDiagnostic> rejected;
+            parse_rules(text, parsed, errors, rejected);
+            Assert::IsTrue(write_rule_cache("test_rules.cache", text, parsed, rejected));
+
+            InputFile cache;
+            vector<ClassRule> loaded;
+            Assert::IsTrue(cache.open("test_rules.cache"));
+            Assert::IsFalse(load_rule_cache(cache.data(), "Blue: property \"color\" contains value 2\n",
+                loaded, errors, rejected));
+            Assert::IsTrue(loaded.empty());
+
+            cache.close();
+            remove("test_rules.cache");
+        }
+
+        TEST_METHOD(Load_NotACache_ShouldFail)
+        {
+            vector<ClassRule> loaded;
+            ErrorSink errors;
+            vector<RuleDiagnostic> rejected;
+            Assert::IsFalse(load_rule_cache("Blue: has property \"color\"", "", loaded, errors, rejected));
+        }
+    };
+}
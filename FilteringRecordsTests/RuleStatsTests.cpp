@@ -0,0 +1,126 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../RuleStats.h"
+#include "../Classifier.h"
+#include "../InputFile.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: RuleStatsTests
+ * --------------------------
+ * Tests rule pass rate statistics: sampling, the stats file and the
+ * rule order they produce, which must never change a result.
+ */
+
+namespace RuleStatsTests
+{
+    TEST_CLASS(RuleStatsTests)
+    {
+    public:
+
+        // Ten records with a color; only the last one is red (2)
+        static vector<Record> makeRecords()
+        {
+            vector<Record> records;
+            for (int i = 0; i < 10; i++) {
+                Record r{ "R" + to_string(i), {{intern_property("color"), {{i == 9 ? 2 : 1}}}} };
+                records.push_back(r);
+            }
+            return records;
+        }
+
+        TEST_METHOD(Sample_CountsPassesPerRule)
+        {
+            RecordStore store(makeRecords());
+            Rule hasColor{ RuleType::HAS_PROPERTY, "color", 0, 0, {} };
+            Rule red{ RuleType::CONTAINS_VALUE, "color", 0, 2, {} };
+            RuleTable table(vector<ClassRule>{ { "Red", {hasColor, red} } });
+
+            RuleStats stats(table);
+            Assert::AreEqual(0.5, stats.passRate(0));
+            stats.sample(store);
+            Assert::AreEqual(uint64_t(10), stats.evaluated(0));
+            Assert::AreEqual(uint64_t(10), stats.passed(0));
+            Assert::AreEqual(uint64_t(1), stats.passed(1));
+            Assert::AreEqual(0.1, stats.passRate(1));
+
+            // Every 5th record only
+            RuleStats sparse(table);
+            sparse.sample(store, 2);
+            Assert::AreEqual(uint64_t(2), sparse.evaluated(1));
+        }
+
+        TEST_METHOD(OrderRules_PutsSelectiveRuleFirst)
+        {
+            RecordStore store(makeRecords());
+            Rule hasColor{ RuleType::HAS_PROPERTY, "color", 0, 0, {} };
+            Rule red{ RuleType::CONTAINS_VALUE, "color", 0, 2, {} };
+            vector<ClassRule> classes{ { "Red", {hasColor, red} }, { "Colored", {hasColor} } };
+            RuleTable table(classes);
+
+            RuleStats stats(table);
+            stats.sample(store);
+            order_rules(table, stats, &store);
+
+            Assert::AreEqual(uint32_t(1), table.classRules(0).data[0]);
+            Assert::AreEqual(uint32_t(0), table.classRules(0).data[1]);
+            Assert::IsTrue(classify(store, RuleTable(classes), classes) == classify(store, table, classes));
+        }
+
+        TEST_METHOD(SaveAndLoad_MergesCountsByRule)
+        {
+            RecordStore store(makeRecords());
+            Rule hasColor{ RuleType::HAS_PROPERTY, "color", 0, 0, {} };
+            Rule red{ RuleType::CONTAINS_VALUE, "color", 0, 2, {} };
+            Rule exact{ RuleType::EQUALS_EXACTLY, "color", 0, 0, {1} };
+            RuleTable table(vector<ClassRule>{ { "Red", {hasColor, red} }, { "One", {exact} } });
+            RuleStats stats(table);
+            stats.sample(store);
+            Assert::IsTrue(stats.save("test_rules.stats"));
+
+            // Different rules text: known rules are found by identity
+            Rule redUpper{ RuleType::CONTAINS_VALUE, "COLOR", 0, 2, {} };
+            Rule blue{ RuleType::CONTAINS_VALUE, "color", 0, 3, {} };
+            RuleTable other(vector<ClassRule>{ { "Blue", {blue} }, { "Red", {redUpper} }, { "One", {exact} } });
+            RuleStats loaded(other);
+            loaded.add(1, true);
+
+            InputFile file;
+            Assert::IsTrue(file.open("test_rules.stats"));
+            Assert::IsTrue(loaded.load(file.data()));
+            Assert::AreEqual(uint64_t(0), loaded.evaluated(0));
+            Assert::AreEqual(uint64_t(11), loaded.evaluated(1));
+            Assert::AreEqual(uint64_t(2), loaded.passed(1));
+            Assert::AreEqual(uint64_t(9), loaded.passed(2));
+
+            Assert::IsFalse(loaded.load(file.data().substr(0, file.data().size() - 8)));
+            Assert::AreEqual(uint64_t(11), loaded.evaluated(1));
+
+            file.close();
+            remove("test_rules.stats");
+        }
+
+        TEST_METHOD(RuleCost_UsesColumnLayout)
+        {
+            vector<Record> records;
+            for (int i = 0; i < 4; i++) {
+                Record r{ "R" + to_string(i), {{intern_property("color"), {{i}}},
+                    {intern_property("tags"), {{i, 100 + i, 1000 * i, -i, 7, 8}}}} };
+                records.push_back(r);
+            }
+            RecordStore store(records);
+            Rule color{ RuleType::CONTAINS_VALUE, "color", 0, 2, {} };
+            Rule tags{ RuleType::CONTAINS_VALUE, "tags", 0, 7, {} };
+            Rule missing{ RuleType::CONTAINS_VALUE, "weight", 0, 7, {} };
+
+            Assert::IsTrue(rule_cost(color, &store) < rule_cost(tags, &store));
+            Assert::IsTrue(rule_cost(missing, &store) <= rule_cost(color, &store));
+            Assert::IsTrue(rule_cost(color, nullptr) > 0.0);
+        }
+    };
+}
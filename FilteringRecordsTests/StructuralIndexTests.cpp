@@ -0,0 +1,68 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <string>
+#include <vector>
+#include "../StructuralIndex.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: StructuralIndexTests
+ * --------------------------------
+ * Tests the structural character scanner used by the record parser.
+ * Every implementation must report exactly the same positions as the
+ * scalar reference, including block tails shorter than 64 bytes.
+ */
+
+namespace StructuralIndexTests
+{
+    TEST_CLASS(StructuralIndexTests)
+    {
+    public:
+
+        TEST_METHOD(RecordLine_ReportsStructurals)
+        {
+            vector<uint32_t> pos;
+            find_structurals("Car: c = [1, 2]\n", pos);
+            vector<uint32_t> expected{ 3, 7, 9, 11, 14, 15 };
+            Assert::IsTrue(pos == expected);
+        }
+
+        TEST_METHOD(EmptyText_ReportsNothing)
+        {
+            vector<uint32_t> pos;
+            find_structurals("", pos);
+            Assert::IsTrue(pos.empty());
+        }
+
+        TEST_METHOD(AllScanners_MatchScalar)
+        {
+            // Mixed text of various lengths around the 64-byte block size
+            string text;
+            const char alphabet[] = "ab :=[],\n 0123456789\t-";
+            for (int i = 0; i < 1000; i++)
+                text.push_back(alphabet[(i * 7 + i / 3) % (sizeof(alphabet) - 1)]);
+
+            for (size_t len : { 0, 1, 15, 16, 63, 64, 65, 127, 128, 200, 1000 }) {
+                string_view part(text.data(), len);
+                vector<uint32_t> scalar, sse2, avx2, automatic;
+                find_structurals(part, scalar, StructuralScanner::SCALAR);
+                find_structurals(part, sse2, StructuralScanner::SSE2);
+                find_structurals(part, avx2, StructuralScanner::AVX2);
+                find_structurals(part, automatic);
+                Assert::IsTrue(scalar == sse2);
+                Assert::IsTrue(scalar == avx2);
+                Assert::IsTrue(scalar == automatic);
+            }
+        }
+
+        TEST_METHOD(AppendsToExistingPositions)
+        {
+            vector<uint32_t> pos{ 99 };
+            find_structurals("a:b", pos);
+            Assert::AreEqual(size_t(2), pos.size());
+            Assert::AreEqual(uint32_t(1), pos[1]);
+        }
+    };
+}
@@ -0,0 +1,71 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <atomic>
+#include <vector>
+#include "../ThreadPool.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: ThreadPoolTests
+ * ---------------------------
+ * Tests the work-stealing pool: every iteration of a loop must run
+ * exactly once, on a valid thread index, whatever the load balance.
+ */
+
+namespace ThreadPoolTests
+{
+    TEST_CLASS(ThreadPoolTests)
+    {
+    public:
+
+        TEST_METHOD(ParallelFor_RunsEveryIterationOnce)
+        {
+            ThreadPool pool(4);
+            Assert::AreEqual(size_t(4), pool.size());
+
+            vector<atomic<int>> runs(1000);
+            atomic<bool> badThread{ false };
+            pool.parallelFor(runs.size(), [&](size_t i, size_t thread) {
+                runs[i]++;
+                if (thread >= pool.size()) badThread = true;
+            });
+
+            for (auto& r : runs)
+                Assert::AreEqual(1, r.load());
+            Assert::IsFalse(badThread.load());
+        }
+
+        TEST_METHOD(ParallelFor_UnevenWork_IsStolen)
+        {
+            // All the work is in the first range; the other threads must
+            // steal it, and the pool must be reusable for further loops
+            ThreadPool pool(3);
+            for (int loop = 0; loop < 20; loop++) {
+                vector<atomic<int>> runs(64);
+                pool.parallelFor(runs.size(), [&](size_t i, size_t) {
+                    volatile unsigned sink = 0;
+                    for (unsigned k = 0; k < (i < 22 ? 20000u : 10u); k++) sink = sink + k;
+                    runs[i]++;
+                });
+                for (auto& r : runs)
+                    Assert::AreEqual(1, r.load());
+            }
+        }
+
+        TEST_METHOD(ParallelFor_EmptyAndSingleThread)
+        {
+            ThreadPool pool(2);
+            int calls = 0;
+            pool.parallelFor(0, [&](size_t, size_t) { calls++; });
+            Assert::AreEqual(0, calls);
+
+            ThreadPool single(1);
+            vector<size_t> order;
+            single.parallelFor(5, [&](size_t i, size_t thread) { order.push_back(i + 10 * thread); });
+            Assert::IsTrue(order == vector<size_t>{ 0, 1, 2, 3, 4 });
+            Assert::IsTrue(ThreadPool().size() >= 1);
+        }
+    };
+}
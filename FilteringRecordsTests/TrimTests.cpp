@@ -59,5 +59,18 @@ namespace TrimTests
             string output = trim(input);
             Assert::AreEqual(""s, output);
         }
+
+        TEST_METHOD(TrimView_ReturnsViewIntoInput)
+        {
+            string input = "  \tview me\r\n";
+            string_view output = trim_view(input);
+            Assert::AreEqual("view me"s, string(output));
+            Assert::IsTrue(output.data() == input.data() + 3);
+        }
+
+        TEST_METHOD(TrimView_OnlySpaces)
+        {
+            Assert::IsTrue(trim_view(" \t \r\n").empty());
+        }
     };
 }
@@ -0,0 +1,66 @@
+#include "pch.h"
+#include <CppUnitTest.h>
+#include <string>
+#include <vector>
+#include "../ValueSearch.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace std;
+
+/*
+ * Test Suite: ValueSearchTests
+ * ----------------------------
+ * Tests the value list kernels: every implementation must agree with
+ * the scalar one for all lengths, including the tails after the last
+ * whole vector. Kernels the CPU lacks fall back and are still checked.
+ */
+
+namespace ValueSearchTests
+{
+    TEST_CLASS(ValueSearchTests)
+    {
+    public:
+
+        TEST_METHOD(ContainsValue_AllKernelsAgree)
+        {
+            const ValueKernel kernels[] = { ValueKernel::SCALAR, ValueKernel::SSE2,
+                ValueKernel::AVX2, ValueKernel::AVX512, ValueKernel::AUTO };
+            vector<int> values;
+            for (int n = 0; n <= 70; n++) {
+                for (int pos = -1; pos < n; pos++) {
+                    // Values 1000.., with -7 at pos (none if pos == -1)
+                    values.assign(n, 0);
+                    for (int i = 0; i < n; i++) values[i] = 1000 + i;
+                    if (pos >= 0) values[pos] = -7;
+                    for (ValueKernel k : kernels)
+                        Assert::AreEqual(pos >= 0, contains_value(values.data(), values.size(), -7, k),
+                            (L"n=" + to_wstring(n) + L" pos=" + to_wstring(pos)).c_str());
+                    Assert::AreEqual(pos >= 0, contains_value(values.data(), values.size(), -7));
+                }
+            }
+        }
+
+        TEST_METHOD(EqualValues_AllKernelsAgree)
+        {
+            const ValueKernel kernels[] = { ValueKernel::SCALAR, ValueKernel::SSE2,
+                ValueKernel::AVX2, ValueKernel::AVX512, ValueKernel::AUTO };
+            for (int n = 0; n <= 70; n++) {
+                vector<int> a(n), b;
+                for (int i = 0; i < n; i++) a[i] = i * 31 - 500;
+                for (int diff = -1; diff < n; diff++) {
+                    b = a;
+                    if (diff >= 0) b[diff] ^= 1 << (diff % 31);
+                    for (ValueKernel k : kernels)
+                        Assert::AreEqual(diff < 0, equal_values(a.data(), b.data(), n, k));
+                    Assert::AreEqual(diff < 0, equal_values(a.data(), b.data(), n));
+                }
+            }
+        }
+
+        TEST_METHOD(ValueKernelName_IsKnown)
+        {
+            string name = value_kernel_name();
+            Assert::IsTrue(name == "avx512" || name == "avx2" || name == "sse2" || name == "scalar");
+        }
+    };
+}
@@ -0,0 +1,236 @@
+/*
+ * File: IncrementalParser.cpp
+ * ---------------------------
+ * Implements incremental parsing of the items file with a sidecar of
+ * per-line content hashes.
+ */
+
+#include "IncrementalParser.h"
+#include "BinaryFormat.h"
+#include "InputFile.h"
+#include "Parser.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+static const char SIDECAR_MAGIC[8] = { 'F', 'R', 'L', 'I', 'N', 'E', 'S', '\0' };
+
+// High bit of a line result: the line was rejected; bits 32-62 hold the
+// column of the error within the trimmed line and the low 32 bits its code
+static const uint64_t SIDECAR_REJECTED = uint64_t(1) << 63;
+static const uint64_t SIDECAR_CODE_MASK = 0xFFFFFFFFULL;
+static const uint64_t SIDECAR_MAX_COLUMN = (uint64_t(1) << 31) - 1;
+
+/*
+ * Method: load
+ * ------------
+ * Checks the header, the section sizes and the embedded snapshot, and
+ * that every stored record index points into the snapshot and every
+ * error code is known.
+ */
+bool IncrementalParser::load(std::string_view sidecar) {
+    previous_ = RecordSnapshot();
+    keys_ = results_ = nullptr;
+    count_ = 0;
+
+    SidecarHeader h;
+    if (sidecar.size() < sizeof(h) || reinterpret_cast<uintptr_t>(sidecar.data()) % 8 != 0)
+        return false;
+    std::memcpy(&h, sidecar.data(), sizeof(h));
+    if (std::memcmp(h.magic, SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC)) != 0 ||
+        h.version != ITEMS_SIDECAR_VERSION || h.byteOrder != BINARY_BYTE_ORDER ||
+        h.lineCount > (sidecar.size() - sizeof(h)) / (2 * sizeof(uint64_t)))
+        return false;
+
+    // The snapshot of the previous records fills the rest of the file
+    size_t columns = sizeof(h) + 2 * static_cast<size_t>(h.lineCount) * sizeof(uint64_t);
+    RecordSnapshot previous;
+    if (!previous.load(sidecar.substr(columns)))
+        return false;
+
+    const uint64_t* keys = reinterpret_cast<const uint64_t*>(sidecar.data() + sizeof(h));
+    const uint64_t* results = keys + h.lineCount;
+    for (uint64_t i = 0; i < h.lineCount; i++) {
+        if (results[i] & SIDECAR_REJECTED) {
+            if ((results[i] & SIDECAR_CODE_MASK) >= ERROR_CODE_COUNT) return false;
+        }
+        else if (results[i] >= previous.size()) {
+            return false;
+        }
+    }
+
+    previous_ = previous;
+    keys_ = keys;
+    results_ = results;
+    count_ = static_cast<size_t>(h.lineCount);
+    return true;
+}
+
+/*
+ * Method: lookup
+ * --------------
+ * Binary search over the sorted line keys of the previous run.
+ */
+bool IncrementalParser::lookup(uint64_t key, size_t& index) const {
+    const uint64_t* it = std::lower_bound(keys_, keys_ + count_, key);
+    if (it == keys_ + count_ || *it != key)
+        return false;
+    index = static_cast<size_t>(it - keys_);
+    return true;
+}
+
+/*
+ * Method: parse
+ * -------------
+ * Walks the lines in order and looks each one up in the sidecar. The
+ * lines that miss (all of them on a first run) are gathered into one
+ * text and parsed with parse_records, on the given threads and into the
+ * arena, like a full parse. A final pass in line order then replays the
+ * known lines (records copied out of the snapshot into the arena,
+ * rejections and errors repeated) and takes the records of the parsed
+ * ones. Records, rejected lines and errors come out exactly as
+ * parse_records() would produce them. records must be empty.
+ */
+void IncrementalParser::parse(std::string_view text, std::vector<Record>& records,
+    ErrorSink& errors, std::vector<std::string_view>& rejected, unsigned threads, RecordArena* arena) {
+    lines_.clear();
+    reusedLines_ = parsedLines_ = 0;
+    upToDate_ = false;
+
+    // Step 1: Look every non-empty line up; collect the misses
+    struct Line {
+        std::string_view clean;  // Trimmed line in text
+        size_t number;           // 1-based line number
+        size_t indent;           // Bytes trimmed from the front
+        uint64_t key;            // content_hash of clean
+        uint64_t result;         // Sidecar result if reused
+        bool reused;
+    };
+    std::vector<Line> lines;
+    std::string missed;
+    std::vector<bool> hit(count_);
+    size_t hitCount = 0;
+    std::string_view line;
+    size_t lineNo = 0;
+    while (next_line(text, line)) {
+        lineNo++;
+
+        // Skip empty lines
+        std::string_view clean = trim_view(line);
+        if (clean.empty()) continue;
+
+        Line l{ clean, lineNo, static_cast<size_t>(clean.data() - line.data()), content_hash(clean), 0, false };
+        size_t index = 0;
+        l.reused = lookup(l.key, index);
+        if (l.reused) {
+            l.result = results_[index];
+            if (!hit[index]) hitCount++;
+            hit[index] = true;
+        }
+        else {
+            missed.append(clean);
+            missed.push_back('\n');
+        }
+        lines.push_back(l);
+    }
+
+    // Step 2: Parse the missed lines in parallel chunks. Only which lines
+    // failed is taken from this parse (their views into missed); errors
+    // are reported in line order below.
+    std::vector<Record> parsed;
+    std::vector<std::string_view> failed;
+    ErrorSink ignored(0);
+    parse_records(missed, parsed, ignored, failed, threads, arena);
+    const Record::allocator_type memory = arena != nullptr ? arena->chunk(0) : Record::allocator_type();
+
+    // Step 3: Merge in line order
+    records.reserve(records.size() + lines.size());
+    size_t offset = 0, nextParsed = 0, nextFailed = 0;
+    for (Line& l : lines) {
+        if (l.reused) {
+            // Unchanged line: reuse the previous result
+            reusedLines_++;
+            if (l.result & SIDECAR_REJECTED) {
+                // The key ignores indentation: add this line's own back
+                size_t column = static_cast<size_t>((l.result & ~SIDECAR_REJECTED) >> 32);
+                if (column > 0) column += l.indent;
+                errors.report(static_cast<ErrorCode>(l.result & SIDECAR_CODE_MASK), "Parser", l.number, column);
+                rejected.push_back(l.clean);
+            }
+            else {
+                records.push_back(previous_.toRecord(static_cast<size_t>(l.result), memory));
+                l.result = records.size() - 1;
+            }
+        }
+        else {
+            // New or changed line: take its outcome from step 2
+            parsedLines_++;
+            bool ok = nextFailed == failed.size() || failed[nextFailed].data() != missed.data() + offset;
+            offset += l.clean.size() + 1;
+            if (ok) {
+                records.push_back(std::move(parsed[nextParsed++]));
+                l.result = records.size() - 1;
+            }
+            else {
+                // Rejections are rare; parse the line again for its error
+                nextFailed++;
+                Record r;
+                Error error;
+                parse_record_line(l.clean, r, error);
+
+                // Store the column within the trimmed line, report it
+                // within the untrimmed one
+                l.result = SIDECAR_REJECTED | static_cast<uint64_t>(error.code) |
+                    (std::min<uint64_t>(error.column, SIDECAR_MAX_COLUMN) << 32);
+                if (error.column > 0)
+                    error.column += l.indent;
+                errors.report(error, l.number);
+                rejected.push_back(l.clean);
+            }
+        }
+        lines_.push_back({ l.key, l.result });
+    }
+
+    // Every line was known and every known line is still there: the
+    // sidecar already describes this text
+    upToDate_ = keys_ != nullptr && missed.empty() && hitCount == count_;
+}
+
+/*
+ * Method: write
+ * -------------
+ * Writes the distinct line keys of the last parse() in sorted order,
+ * their results, and a snapshot of records (the records filled in by
+ * that parse()).
+ */
+bool IncrementalParser::write(const std::string& path, const std::vector<Record>& records) const {
+    // Identical lines have identical results; keep one entry per key
+    std::vector<std::pair<uint64_t, uint64_t>> lines = lines_;
+    std::sort(lines.begin(), lines.end());
+    lines.erase(std::unique(lines.begin(), lines.end(),
+        [](const auto& a, const auto& b) { return a.first == b.first; }), lines.end());
+
+    std::vector<uint64_t> keys, results;
+    for (const auto& l : lines) {
+        keys.push_back(l.first);
+        results.push_back(l.second);
+    }
+
+    SidecarHeader header{};
+    std::memcpy(header.magic, SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC));
+    header.version = ITEMS_SIDECAR_VERSION;
+    header.byteOrder = BINARY_BYTE_ORDER;
+    header.lineCount = lines.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_section(out, keys.data(), keys.size() * sizeof(uint64_t));
+    write_section(out, results.data(), results.size() * sizeof(uint64_t));
+    if (!write_record_snapshot(out, records)) return false;
+
+    out.close();
+    return !out.fail();
+}
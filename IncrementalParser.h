@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Record.h"
+#include "RecordArena.h"
+#include "ErrorSink.h"
+#include "RecordSnapshot.h"
+
+/*
+ * File: IncrementalParser.h
+ * -------------------------
+ * Incremental parsing of the items file.
+ *
+ * The result of parsing an items line depends only on its text, so a
+ * sidecar file written after each run maps the content hash of every
+ * non-empty line to what it produced: a record, or a rejection with its
+ * error code. On the next run only lines whose hash is not in the
+ * sidecar are parsed (in parallel chunks, as by parse_records); the
+ * records of all other lines are copied out of the sidecar.
+ *
+ * Sidecar layout (native byte order, every section 8-byte aligned):
+ *
+ *   SidecarHeader
+ *   uint64 lineKeys   [lineCount]  content_hash of the trimmed line, sorted
+ *   uint64 lineResults[lineCount]  record index in the snapshot, or
+ *                                  SIDECAR_REJECTED | column << 32 | error code
+ *                                  (column within the trimmed line, so a
+ *                                  re-indented line reports its new one)
+ *   record snapshot                (RecordSnapshot, to the end of the file)
+ */
+
+// Version of the sidecar layout; bumped on every incompatible change
+const uint32_t ITEMS_SIDECAR_VERSION = 2;
+
+/*
+ * Structure: SidecarHeader
+ * ------------------------
+ * Fixed-size header at the start of a sidecar file.
+ */
+struct SidecarHeader {
+    char magic[8];       // "FRLINES" followed by '\0'
+    uint32_t version;    // ITEMS_SIDECAR_VERSION
+    uint32_t byteOrder;  // BINARY_BYTE_ORDER in the writer's byte order
+    uint64_t lineCount;  // Number of distinct lines
+};
+
+/*
+ * Class: IncrementalParser
+ * ------------------------
+ * Parses an items file, reusing the results of the previous run kept
+ * in a sidecar, and records the results of this run for the next one.
+ *
+ * Example:
+ *   IncrementalParser parser;
+ *   parser.load(previousSidecar.data());  // optional
+ *   parser.parse(items.data(), records, errors, rejected, threads, &arena);
+ *   previousSidecar.close();
+ *   if (!parser.upToDate()) parser.write("items.lines", records);
+ */
+class IncrementalParser {
+public:
+    // Attaches to the sidecar of the previous run (which must outlive
+    // parse()); returns false and keeps no state if it is unusable
+    bool load(std::string_view sidecar);
+
+    // Same parameters and outputs as parse_records(); see the class
+    // description
+    void parse(std::string_view text, std::vector<Record>& records, ErrorSink& errors,
+        std::vector<std::string_view>& rejected, unsigned threads = 1, RecordArena* arena = nullptr);
+
+    // Writes the sidecar for the lines seen by the last parse()
+    bool write(const std::string& path, const std::vector<Record>& records) const;
+
+    // Lines taken from the sidecar / parsed by the last parse()
+    size_t reusedLines() const { return reusedLines_; }
+    size_t parsedLines() const { return parsedLines_; }
+
+    // True if the last parse() only met the lines of the loaded sidecar,
+    // all of them: rewriting it would change nothing
+    bool upToDate() const { return upToDate_; }
+
+private:
+    bool lookup(uint64_t key, size_t& index) const;
+
+    // Previous run
+    RecordSnapshot previous_;
+    const uint64_t* keys_ = nullptr;
+    const uint64_t* results_ = nullptr;
+    size_t count_ = 0;
+
+    // This run: (key, result) for every non-empty line
+    std::vector<std::pair<uint64_t, uint64_t>> lines_;
+    size_t reusedLines_ = 0;
+    size_t parsedLines_ = 0;
+    bool upToDate_ = false;
+};
@@ -0,0 +1,149 @@
+/*
+ * File: InputFile.cpp
+ * -------------------
+ * Implements memory-mapped input files with a buffered fallback.
+ */
+
+#include "InputFile.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+InputFile::~InputFile() {
+    close();
+}
+
+/*
+ * Method: open
+ * ------------
+ * Maps a regular file into memory. Empty files, non-regular files and
+ * standard input fall back to reading the stream into buffer_.
+ *
+ * Returns:
+ *   true  if the contents are available through data(),
+ *   false if the file cannot be opened or read.
+ */
+bool InputFile::open(const std::string& path) {
+    close();
+
+    if (path == "-")
+        return readStream(stdin);
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            mappedView_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);  // The view keeps the mapping alive
+        }
+    }
+    CloseHandle(file);
+
+    if (mappedView_ != nullptr) {
+        data_ = static_cast<const char*>(mappedView_);
+        size_ = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            mappedView_ = view;
+            data_ = static_cast<const char*>(view);
+            size_ = static_cast<size_t>(st.st_size);
+        }
+    }
+    ::close(fd);
+
+    if (mappedView_ != nullptr)
+        return true;
+#endif
+
+    // Fallback: pipes, devices, empty files or failed mappings
+    std::FILE* stream = std::fopen(path.c_str(), "rb");
+    if (stream == nullptr)
+        return false;
+    bool ok = readStream(stream);
+    std::fclose(stream);
+    return ok;
+}
+
+/*
+ * Method: readStream
+ * ------------------
+ * Reads a stream to the end into the owned buffer.
+ */
+bool InputFile::readStream(std::FILE* stream) {
+    char chunk[1 << 16];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), stream)) > 0)
+        buffer_.append(chunk, n);
+    if (std::ferror(stream))
+        return false;
+
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    return true;
+}
+
+/*
+ * Method: close
+ * -------------
+ * Unmaps the file or frees the buffer; data() becomes empty.
+ */
+void InputFile::close() {
+    if (mappedView_ != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mappedView_);
+#else
+        munmap(mappedView_, size_);
+#endif
+        mappedView_ = nullptr;
+    }
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    data_ = "";
+    size_ = 0;
+}
+
+/*
+ * Function: next_line
+ * -------------------
+ * Returns the text up to the next '\n' and advances past it.
+ */
+bool next_line(std::string_view& text, std::string_view& line) {
+    if (text.empty())
+        return false;
+
+    size_t nl = text.find('\n');
+    if (nl == std::string_view::npos) {
+        line = text;
+        text = {};
+    }
+    else {
+        line = text.substr(0, nl);
+        text.remove_prefix(nl + 1);
+    }
+    return true;
+}
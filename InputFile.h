@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+/*
+ * Class: InputFile
+ * ----------------
+ * Read-only view of a whole input file as one contiguous buffer.
+ *
+ * Regular files are memory-mapped (with sequential-access hints so the
+ * kernel can read ahead), which lets the parser walk lines in place
+ * without copying them. Pipes, character devices and standard input
+ * ("-") cannot be mapped and are read into an owned buffer instead.
+ *
+ * Example:
+ *   InputFile in;
+ *   if (in.open("items.txt")) {
+ *       std::string_view text = in.data(), line;
+ *       while (next_line(text, line)) { ... }
+ *   }
+ */
+class InputFile {
+public:
+    InputFile() = default;
+    ~InputFile();
+
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    // Opens and maps (or reads) the file; "-" means standard input
+    bool open(const std::string& path);
+
+    // Releases the mapping or buffer
+    void close();
+
+    // Whole file contents (valid until close() or destruction)
+    std::string_view data() const { return { data_, size_ }; }
+
+    // True if the contents are memory-mapped rather than copied
+    bool isMapped() const { return mappedView_ != nullptr; }
+
+private:
+    bool readStream(std::FILE* stream);
+
+    const char* data_ = "";       // Start of the contents
+    size_t size_ = 0;             // Size of the contents in bytes
+    void* mappedView_ = nullptr;  // Base address of the mapping, if any
+    std::string buffer_;          // Owned copy for sources that cannot be mapped
+};
+
+/*
+ * Function: next_line
+ * -------------------
+ * Splits the next line off the front of text, like std::getline:
+ * the line excludes the '\n', and a final line without a newline is
+ * still returned.
+ *
+ * Returns:
+ *   true  if a line was extracted,
+ *   false when text is exhausted.
+ */
+bool next_line(std::string_view& text, std::string_view& line);
@@ -0,0 +1,173 @@
+/*
+ * File: InvertedIndex.cpp
+ * -----------------------
+ * Builds the inverted index of a record store and intersects posting
+ * lists.
+ */
+
+#include "InvertedIndex.h"
+#include <algorithm>
+#include <utility>
+
+/*
+ * Constructor: InvertedIndex
+ * --------------------------
+ * Indexes every value of every column of the store.
+ */
+InvertedIndex::InvertedIndex(const RecordStore& store) : recordCount_(store.size()) {
+    for (PropertyId id : store.properties())
+        addProperty(store, id, nullptr);
+}
+
+/*
+ * Constructor: InvertedIndex
+ * --------------------------
+ * Collects the values CONTAINS_VALUE rules ask for, per property, and
+ * indexes only the columns the rules name; a column no rule looks up a
+ * value of gets its presence list alone.
+ */
+InvertedIndex::InvertedIndex(const RecordStore& store, const std::vector<ClassRule>& classRules)
+    : recordCount_(store.size()) {
+    std::vector<std::vector<int>> wanted;   // By PropertyId
+    std::vector<bool> named;                // By PropertyId
+    for (const auto& c : classRules) {
+        for (const auto& rule : c.rules) {
+            if (store.column(rule.propertyId) == nullptr) continue;
+            if (rule.propertyId >= named.size()) {
+                named.resize(rule.propertyId + 1, false);
+                wanted.resize(rule.propertyId + 1);
+            }
+            named[rule.propertyId] = true;
+            if (rule.type == CONTAINS_VALUE)
+                wanted[rule.propertyId].push_back(rule.expectedValue);
+        }
+    }
+
+    for (PropertyId id : store.properties()) {
+        if (id >= named.size() || !named[id]) continue;
+        std::vector<int>& values = wanted[id];
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        addProperty(store, id, &values);
+    }
+}
+
+/*
+ * Method: addProperty
+ * -------------------
+ * One pass over the column collects the presence list and a (value,
+ * record) pair for every distinct indexed value of every record;
+ * sorting the pairs groups them by value with the records of each
+ * value in ascending order, ready to be cut into posting lists.
+ */
+void InvertedIndex::addProperty(const RecordStore& store, PropertyId id, const std::vector<int>* wanted) {
+    const PropertyColumn& column = *store.column(id);
+    if (id >= propertyIndex_.size())
+        propertyIndex_.resize(id + 1, -1);
+    propertyIndex_[id] = static_cast<int32_t>(properties_.size());
+    properties_.emplace_back();
+    PropertyPostings& p = properties_.back();
+    p.present.reserve(column.presentCount());
+
+    // Step 1: Presence and distinct (value, record) pairs
+    std::vector<std::pair<int, uint32_t>> pairs;
+    IntList values;
+    const bool anyValues = wanted == nullptr || !wanted->empty();
+    for (size_t r = 0; r < store.size(); r++) {
+        if (!column.has(r)) continue;
+        p.present.push_back(static_cast<uint32_t>(r));
+        if (!anyValues) continue;
+        column.readValues(r, values);
+        std::sort(values.begin(), values.end());
+        for (size_t i = 0; i < values.size(); i++) {
+            if (i > 0 && values[i] == values[i - 1]) continue;
+            if (wanted == nullptr || std::binary_search(wanted->begin(), wanted->end(), values[i]))
+                pairs.emplace_back(values[i], static_cast<uint32_t>(r));
+        }
+    }
+
+    // Step 2: Group by value
+    std::sort(pairs.begin(), pairs.end());
+    p.records.reserve(pairs.size());
+    for (size_t i = 0; i < pairs.size(); i++) {
+        if (i == 0 || pairs[i].first != pairs[i - 1].first) {
+            p.values.push_back(pairs[i].first);
+            p.offsets.push_back(static_cast<uint32_t>(i));
+        }
+        p.records.push_back(pairs[i].second);
+    }
+    p.offsets.push_back(static_cast<uint32_t>(pairs.size()));
+}
+
+/*
+ * Method: postings
+ * ----------------
+ * Direct lookup by property id.
+ */
+const InvertedIndex::PropertyPostings* InvertedIndex::postings(PropertyId id) const {
+    if (id >= propertyIndex_.size() || propertyIndex_[id] < 0)
+        return nullptr;
+    return &properties_[propertyIndex_[id]];
+}
+
+/*
+ * Method: withProperty
+ * --------------------
+ * Presence list of the property; empty if no record has it.
+ */
+PostingView InvertedIndex::withProperty(PropertyId id) const {
+    const PropertyPostings* p = postings(id);
+    if (p == nullptr) return {};
+    return { p->present.data(), p->present.size() };
+}
+
+/*
+ * Method: withValue
+ * -----------------
+ * Binary search for the value among the distinct values of the
+ * property; empty if no record contains it.
+ */
+PostingView InvertedIndex::withValue(PropertyId id, int value) const {
+    const PropertyPostings* p = postings(id);
+    if (p == nullptr) return {};
+    auto it = std::lower_bound(p->values.begin(), p->values.end(), value);
+    if (it == p->values.end() || *it != value) return {};
+    size_t v = static_cast<size_t>(it - p->values.begin());
+    return { p->records.data() + p->offsets[v], p->offsets[v + 1] - p->offsets[v] };
+}
+
+/*
+ * Function: gallop
+ * ----------------
+ * First position in [first, last) whose id is not below id: steps of
+ * doubling length bracket the position, then a binary search finds it.
+ */
+static const uint32_t* gallop(const uint32_t* first, const uint32_t* last, uint32_t id) {
+    if (first == last || *first >= id) return first;
+    size_t step = 1;
+    while (step < static_cast<size_t>(last - first) && first[step] < id) {
+        first += step;
+        step *= 2;
+    }
+    const uint32_t* bound = step < static_cast<size_t>(last - first) ? first + step + 1 : last;
+    return std::lower_bound(first + 1, bound, id);
+}
+
+/*
+ * Function: intersect_postings
+ * ----------------------------
+ * Walks a and gallops through b; matching ids are compacted in place.
+ */
+void intersect_postings(PostingList& a, PostingView b) {
+    size_t kept = 0;
+    const uint32_t* pos = b.begin();
+    for (uint32_t id : a) {
+        pos = gallop(pos, b.end(), id);
+        if (pos == b.end()) break;
+        if (*pos == id) {
+            a[kept++] = id;
+            ++pos;
+        }
+    }
+    a.resize(kept);
+}
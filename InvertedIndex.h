@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "RecordStore.h"
+#include "Rule.h"
+
+/*
+ * File: InvertedIndex.h
+ * ---------------------
+ * Inverted index over the records of a RecordStore.
+ */
+
+// Sorted list of record ids
+using PostingList = std::vector<uint32_t>;
+
+/*
+ * Structure: PostingView
+ * ----------------------
+ * Read-only view of a sorted list of record ids inside an index.
+ */
+struct PostingView {
+    const uint32_t* data = nullptr;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const uint32_t* begin() const { return data; }
+    const uint32_t* end() const { return data + count; }
+    uint32_t operator[](size_t i) const { return data[i]; }
+};
+
+/*
+ * Class: InvertedIndex
+ * --------------------
+ * Maps each property to the records that have it, and each (property,
+ * value) pair to the records whose values of the property contain the
+ * value. All lists are sorted by record id, so a record set defined by
+ * several HAS_PROPERTY / CONTAINS_VALUE rules is the intersection of
+ * their lists instead of a scan over all records.
+ *
+ * Per property the postings are stored CSR-style: the distinct values in
+ * ascending order, offsets into one array of record ids, and a lookup
+ * is a binary search over the distinct values.
+ *
+ * An index built for a rule set covers only what the rules ask: the
+ * presence list of every property a rule names, and posting lists for
+ * the values CONTAINS_VALUE rules look for. Other properties and values
+ * are not indexed (withValue finds no records for them).
+ *
+ * Example:
+ *   InvertedIndex index(store);
+ *   PostingView red = index.withValue(intern_property("color"), 2);
+ *   // red.size() records contain color 2
+ */
+class InvertedIndex {
+public:
+    InvertedIndex() = default;
+    explicit InvertedIndex(const RecordStore& store);
+
+    // Index of the properties and values classRules need (see above)
+    InvertedIndex(const RecordStore& store, const std::vector<ClassRule>& classRules);
+
+    // Number of records of the indexed store
+    size_t recordCount() const { return recordCount_; }
+
+    // Records that have the property
+    PostingView withProperty(PropertyId id) const;
+
+    // Records whose values of the property contain value
+    PostingView withValue(PropertyId id, int value) const;
+
+private:
+    struct PropertyPostings {
+        PostingList present;              // Records with the property
+        std::vector<int> values;          // Distinct values, ascending
+        std::vector<uint32_t> offsets;    // values.size() + 1 into records
+        PostingList records;              // Records of each value, concatenated
+    };
+
+    const PropertyPostings* postings(PropertyId id) const;
+
+    // Indexes one property: all its values (wanted = nullptr) or those
+    // in the sorted list wanted
+    void addProperty(const RecordStore& store, PropertyId id, const std::vector<int>* wanted);
+
+    size_t recordCount_ = 0;
+    std::vector<PropertyPostings> properties_;
+    std::vector<int32_t> propertyIndex_;  // By PropertyId, -1 if not indexed
+};
+
+/*
+ * Function: intersect_postings
+ * ----------------------------
+ * Keeps in a only the ids that are also in b. Galloping search through
+ * b keeps intersecting a short list with a long one at
+ * O(a.size() * log(b.size())).
+ */
+void intersect_postings(PostingList& a, PostingView b);
@@ -1,32 +1,39 @@
 #include "Matching.h"
+#include "ValueSearch.h"
 
 /*
  * Function: match_rule
  * --------------------
- * Evaluates a single rule against a record.
+ * Evaluates a single rule against a record. The property is looked up
+ * by the interned id of the rule in the sorted entries of the record, and
+ * its values are read in place from the record's value buffer.
  */
 bool match_rule(const Record& record, const Rule& rule) {
-    auto it = record.properties.find(rule.propertyName);
-    if (it == record.properties.end()) {
-        if (rule.type == HAS_PROPERTY) return false;
-        return false;
-    }
-    const Property& prop = it->second;
+    const PropertyEntry* prop = record.getProperty(rule.propertyId);
+    if (prop == nullptr) return false;
+    return match_values(rule, record.values.data() + prop->offset, prop->length);
+}
 
+/*
+ * Function: match_values
+ * ----------------------
+ * Evaluates a rule against the values of a present property. Long value
+ * lists are compared with the vector kernels of ValueSearch.h.
+ */
+bool match_values(const Rule& rule, const int* values, size_t count) {
     switch (rule.type) {
     case HAS_PROPERTY:
         return true;
 
     case PROPERTY_SIZE:
-        return (int)prop.values.size() == rule.expectedSize;
+        return (int)count == rule.expectedSize;
 
     case CONTAINS_VALUE:
-        for (int v : prop.values)
-            if (v == rule.expectedValue) return true;
-        return false;
+        return contains_value(values, count, rule.expectedValue);
 
     case EQUALS_EXACTLY:
-        return prop.values == rule.expectedExactValues;
+        return count == rule.expectedExactValues.size() &&
+            equal_values(values, rule.expectedExactValues.data(), count);
 
     default:
         return false;
@@ -45,3 +52,59 @@ bool match_all_rules(const Record& record, const ClassRule& classRule) {
     }
     return true;
 }
+
+/*
+ * Function: match_rule
+ * --------------------
+ * Evaluates a single rule against a record of a store: the column of
+ * the rule's property is found by id and compares the record's values
+ * in whatever form it holds them. CONTAINS_VALUE uses the column's
+ * inferred layout instead of scanning the values, and neither it nor
+ * EQUALS_EXACTLY unpacks a packed column.
+ */
+bool match_rule(const RecordStore& store, size_t record, const Rule& rule) {
+    const PropertyColumn* column = store.column(rule.propertyId);
+    if (column == nullptr || !column->has(record)) return false;
+    if (rule.type == CONTAINS_VALUE)
+        return column->contains(record, rule.expectedValue);
+    if (rule.type == EQUALS_EXACTLY)
+        return column->equals(record, rule.expectedExactValues.data(), rule.expectedExactValues.size());
+    // HAS_PROPERTY and PROPERTY_SIZE only look at the number of values
+    return match_values(rule, nullptr, column->count(record));
+}
+
+/*
+ * Function: match_all_rules
+ * -------------------------
+ * Returns true if a record of a store satisfies all rules of a class.
+ */
+bool match_all_rules(const RecordStore& store, size_t record, const ClassRule& classRule) {
+    for (const auto& r : classRule.rules) {
+        if (!match_rule(store, record, r))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Function: match_class
+ * ---------------------
+ * Same short-circuit as match_all_rules, over rule ids: a rule shared
+ * with an earlier class of the same record is not evaluated again.
+ */
+bool match_class(const Record& record, const RuleTable& table, size_t classIndex, RuleMemo& memo) {
+    for (uint32_t id : table.classRules(classIndex)) {
+        if (!memo.get(id, [&] { return match_rule(record, table.rule(id)); }))
+            return false;
+    }
+    return true;
+}
+
+bool match_class(const RecordStore& store, size_t record, const RuleTable& table,
+    size_t classIndex, RuleMemo& memo) {
+    for (uint32_t id : table.classRules(classIndex)) {
+        if (!memo.get(id, [&] { return match_rule(store, record, table.rule(id)); }))
+            return false;
+    }
+    return true;
+}
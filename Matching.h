@@ -1,7 +1,9 @@
 #pragma once
 #include <vector>
 #include "Record.h"
+#include "RecordStore.h"
 #include "Rule.h"
+#include "RuleTable.h"
 #include "DataCheckResult.h"
 
 /*
@@ -11,9 +13,45 @@
  */
 bool match_rule(const Record& record, const Rule& rule);
 
+/*
+ * Function: match_values
+ * ----------------------
+ * Checks a rule against the values of a property that is known to be
+ * present (count values starting at values). Shared by every record
+ * representation, so all of them follow the same matching semantics.
+ */
+bool match_values(const Rule& rule, const int* values, size_t count);
+
 /*
  * Function: match_all_rules
  * -------------------------
  * Checks if a record satisfies all rules of a class.
  */
 bool match_all_rules(const Record& record, const ClassRule& classRule);
+
+/*
+ * Function: match_rule
+ * --------------------
+ * Checks if record number record of a columnar store satisfies a single
+ * rule. Same semantics as match_rule on a Record.
+ */
+bool match_rule(const RecordStore& store, size_t record, const Rule& rule);
+
+/*
+ * Function: match_all_rules
+ * -------------------------
+ * Checks if record number record of a columnar store satisfies all
+ * rules of a class.
+ */
+bool match_all_rules(const RecordStore& store, size_t record, const ClassRule& classRule);
+
+/*
+ * Function: match_class
+ * ---------------------
+ * Checks if a record satisfies all rules of class number classIndex of
+ * a rule table. Rules already evaluated for this record are read from
+ * memo; the memo must be reset before the first class of each record.
+ */
+bool match_class(const Record& record, const RuleTable& table, size_t classIndex, RuleMemo& memo);
+bool match_class(const RecordStore& store, size_t record, const RuleTable& table,
+    size_t classIndex, RuleMemo& memo);
@@ -0,0 +1,163 @@
+/*
+ * File: PackedInts.cpp
+ * --------------------
+ * Packing, unpacking and searching of frame-of-reference packed ints.
+ */
+
+#include "PackedInts.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+
+#if FR_X86
+#include <immintrin.h>
+#endif
+
+/*
+ * Function: packed_width
+ * ----------------------
+ * Smallest power-of-two number of bits (0 for a zero range) that holds
+ * every offset up to range.
+ */
+static unsigned packed_width(uint64_t range) {
+    unsigned width = 0;
+    while (width < 32 && (width == 0 ? range != 0 : (range >> width) != 0))
+        width = width == 0 ? 1 : width * 2;
+    return width;
+}
+
+/*
+ * Function: broadcast
+ * -------------------
+ * Repeats a value of width bits in every lane of a 64-bit word.
+ */
+static inline uint64_t broadcast(uint64_t value, unsigned width) {
+    return value * (~uint64_t(0) / ((uint64_t(1) << width) - 1));
+}
+
+/*
+ * Function: lane_range
+ * --------------------
+ * Mask of the bits of lanes [first, last) of a word.
+ */
+static inline uint64_t lane_range(unsigned first, unsigned last, unsigned width) {
+    unsigned from = first * width, to = last * width;
+    uint64_t upper = to >= 64 ? ~uint64_t(0) : (uint64_t(1) << to) - 1;
+    return upper & ~((uint64_t(1) << from) - 1);
+}
+
+/*
+ * Constructor: PackedInts
+ * -----------------------
+ * Finds the range of the values, then packs them with set, lowest lane
+ * first.
+ */
+PackedInts::PackedInts(const std::vector<int>& values) {
+    if (values.empty()) return;
+
+    auto range = std::minmax_element(values.begin(), values.end());
+    *this = PackedInts(values.size(), *range.first, *range.second);
+    for (size_t i = 0; i < size_; i++)
+        set(i, values[i]);
+}
+
+/*
+ * Constructor: PackedInts
+ * -----------------------
+ * Picks the width from the range and allocates zeroed words, so that
+ * set only has to OR each value into place.
+ */
+PackedInts::PackedInts(size_t size, int lo, int hi) : size_(size), base_(lo) {
+    if (size == 0) return;
+
+    width_ = packed_width(static_cast<uint64_t>(static_cast<int64_t>(hi) - lo));
+    if (width_ == 0) return;
+
+    const unsigned lanes = 64 / width_;
+    words_.assign((size_ + lanes - 1) / lanes, 0);
+}
+
+/*
+ * Method: decode
+ * --------------
+ * 8- and 16-bit values are whole bytes in memory order, so SSE2 widens
+ * and rebases 16 or 8 of them per step; other widths and the tail are
+ * unpacked one by one.
+ */
+void PackedInts::decode(size_t first, size_t count, int* out) const {
+    size_t i = 0;
+#if FR_X86
+    if (cpu_features().sse2 && (width_ == 8 || width_ == 16)) {
+        const char* bytes = reinterpret_cast<const char*>(words_.data());
+        const __m128i base = _mm_set1_epi32(base_);
+        const __m128i zero = _mm_setzero_si128();
+        if (width_ == 8) {
+            for (; i + 16 <= count; i += 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + first + i));
+                __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+                int* o = out + i;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o), _mm_add_epi32(_mm_unpacklo_epi16(lo, zero), base));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 4), _mm_add_epi32(_mm_unpackhi_epi16(lo, zero), base));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 8), _mm_add_epi32(_mm_unpacklo_epi16(hi, zero), base));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 12), _mm_add_epi32(_mm_unpackhi_epi16(hi, zero), base));
+            }
+        }
+        else {
+            for (; i + 8 <= count; i += 8) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + 2 * (first + i)));
+                int* o = out + i;
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o), _mm_add_epi32(_mm_unpacklo_epi16(v, zero), base));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(o + 4), _mm_add_epi32(_mm_unpackhi_epi16(v, zero), base));
+            }
+        }
+    }
+#endif
+    for (; i < count; i++)
+        out[i] = (*this)[first + i];
+}
+
+/*
+ * Method: contains
+ * ----------------
+ * Searches the packed words directly: the value is turned into its
+ * offset, repeated in every lane and XORed with each word, so lanes that
+ * hold the value become zero. Zero lanes are found for a whole word at
+ * once with carry-free arithmetic (the high bit of each lane is set in
+ * the result exactly when the lane is zero), then restricted to the
+ * lanes inside [first, last).
+ */
+bool PackedInts::contains(size_t first, size_t last, int value) const {
+    if (first >= last) return false;
+    int64_t offset = static_cast<int64_t>(value) - base_;
+    if (offset < 0 || static_cast<uint64_t>(offset) > laneMask()) return false;
+    if (width_ == 0) return true;
+
+    const unsigned lanes = 64 / width_;
+    const uint64_t pattern = broadcast(static_cast<uint64_t>(offset), width_);
+    const uint64_t high = broadcast(uint64_t(1) << (width_ - 1), width_);
+    const uint64_t low = broadcast((uint64_t(1) << (width_ - 1)) - 1, width_);
+    const size_t firstWord = first / lanes, lastWord = (last - 1) / lanes;
+
+    for (size_t w = firstWord; w <= lastWord; w++) {
+        uint64_t x = words_[w] ^ pattern;
+        uint64_t zero = ~(((x & low) + low) | x | low) & high;
+        unsigned from = w == firstWord ? static_cast<unsigned>(first % lanes) : 0;
+        unsigned to = w == lastWord ? static_cast<unsigned>((last - 1) % lanes) + 1 : lanes;
+        if (zero & lane_range(from, to, width_))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * Method: equals
+ * --------------
+ * Element-wise comparison; the lists compared are short rule operands,
+ * so the values are unpacked one at a time and the scan stops at the
+ * first difference.
+ */
+bool PackedInts::equals(size_t first, size_t last, const int* values, size_t count) const {
+    if (last - first != count) return false;
+    for (size_t i = 0; i < count; i++)
+        if ((*this)[first + i] != values[i]) return false;
+    return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * File: PackedInts.h
+ * ------------------
+ * Frame-of-reference bit-packed integer array.
+ */
+
+/*
+ * Class: PackedInts
+ * -----------------
+ * Read-only array of ints stored as offsets from the smallest value
+ * (the frame of reference), each in the fewest bits that hold the
+ * largest offset. Widths are rounded up to a power of two (0, 1, 2, 4,
+ * 8, 16 or 32 bits) so that no value straddles two words: a 64-bit word
+ * holds 64 / width values, and a word can be searched for a value
+ * without unpacking it (see contains).
+ *
+ * Enum-like codes such as colors or sizes (values 0..200) take 8 bits
+ * instead of 32; a property whose values are all equal takes no space.
+ *
+ * Example:
+ *   PackedInts p(std::vector<int>{ 100, 103, 101 });  // base 100, width 2
+ *   p[1];                 // 103
+ *   p.contains(0, 3, 101); // true
+ */
+class PackedInts {
+public:
+    PackedInts() = default;
+    explicit PackedInts(const std::vector<int>& values);
+
+    // Room for size values within [lo, hi], to be filled in with set
+    PackedInts(size_t size, int lo, int hi);
+
+    // Stores value (within [lo, hi]) at index i; each index is set once
+    void set(size_t i, int value) {
+        if (width_ == 0) return;
+        const unsigned lanes = 64 / width_;
+        uint64_t offset = static_cast<uint64_t>(static_cast<int64_t>(value) - base_);
+        words_[i / lanes] |= offset << ((i % lanes) * width_);
+    }
+
+    // Number of values
+    size_t size() const { return size_; }
+
+    // Frame of reference and bits per value
+    int base() const { return base_; }
+    unsigned width() const { return width_; }
+
+    // Memory used by the packed words, in bytes
+    size_t bytes() const { return words_.size() * sizeof(uint64_t); }
+
+    // Value at index i
+    int operator[](size_t i) const {
+        if (width_ == 0) return base_;
+        const unsigned lanes = 64 / width_;
+        uint64_t offset = (words_[i / lanes] >> ((i % lanes) * width_)) & laneMask();
+        return static_cast<int>(static_cast<int64_t>(base_) + static_cast<int64_t>(offset));
+    }
+
+    // Unpacks the values [first, first + count) into out
+    void decode(size_t first, size_t count, int* out) const;
+
+    // True if one of the values [first, last) equals value
+    bool contains(size_t first, size_t last, int value) const;
+
+    // True if the values [first, last) equal values[0 .. count)
+    bool equals(size_t first, size_t last, const int* values, size_t count) const;
+
+private:
+    // Bits of one value within its word
+    uint64_t laneMask() const { return (uint64_t(1) << width_) - 1; }
+
+    std::vector<uint64_t> words_;
+    size_t size_ = 0;
+    int base_ = 0;
+    unsigned width_ = 0;
+};
@@ -12,15 +12,37 @@
 
 #include "Parser.h"
 #include "Error.h"
-#include <sstream>
+#include "StructuralIndex.h"
+#include "InputFile.h"
 #include <cctype>
 #include <algorithm>
+#include <iterator>
 #include <set>
+#include <string_view>
+#include <thread>
 
 // ============================================================================
 // Helper Functions
 // ============================================================================
 
+/**
+ * Function: trim_view
+ * -------------------
+ * Non-allocating counterpart of trim(): returns a view of the input
+ * without leading and trailing whitespace.
+ *
+ * @param s Input text to trim
+ * @return View into s without leading/trailing whitespace (empty if s is blank)
+ *
+ * Complexity: CCN = 2, NLOC = 6
+ */
+std::string_view trim_view(std::string_view s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string_view::npos) return {};
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
 /**
  * Function: trim
  * --------------
@@ -29,13 +51,133 @@
  * @param s Input string to trim
  * @return Trimmed string without leading/trailing whitespace
  *
- * Complexity: CCN = 2, NLOC = 6
+ * Complexity: CCN = 1, NLOC = 3
  */
 std::string trim(const std::string& s) {
-    size_t b = s.find_first_not_of(" \t\r\n");
-    if (b == std::string::npos) return "";
-    size_t e = s.find_last_not_of(" \t\r\n");
-    return s.substr(b, e - b + 1);
+    return std::string(trim_view(s));
+}
+
+/**
+ * Function: is_list_separator
+ * ---------------------------
+ * Returns true for characters that separate values in an integer list:
+ * commas, semicolons and whitespace.
+ */
+static inline bool is_list_separator(char c) {
+    return c == ',' || c == ';' || c == ' ' || c == '\t' ||
+        c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * Function: scan_int
+ * ------------------
+ * Reads an optionally signed decimal integer starting at text[i] and
+ * advances i past it. What follows the digits is not checked.
+ *
+ * @param text Source text
+ * @param i Position of the first character; on success, one past the last digit
+ * @param value Receives the parsed value
+ * @return OK, INVALID_TOKEN if there are no digits, OUT_OF_RANGE if it does not fit into an int
+ *
+ * Complexity: CCN = 7, NLOC = 20
+ */
+static IntListStatus scan_int(std::string_view text, size_t& i, int& value) {
+    const size_t n = text.size();
+
+    // Optional sign
+    bool negative = false;
+    if (i < n && (text[i] == '+' || text[i] == '-')) {
+        negative = (text[i] == '-');
+        i++;
+    }
+
+    // Accumulate digits; the magnitude limit depends on the sign
+    const unsigned long long limit = negative ? 2147483648ULL : 2147483647ULL;
+    unsigned long long magnitude = 0;
+    size_t digitsStart = i;
+    while (i < n && text[i] >= '0' && text[i] <= '9') {
+        magnitude = magnitude * 10 + static_cast<unsigned>(text[i] - '0');
+        if (magnitude > limit)
+            return IntListStatus::OUT_OF_RANGE;
+        i++;
+    }
+    if (i == digitsStart)
+        return IntListStatus::INVALID_TOKEN;
+
+    value = negative ? static_cast<int>(-static_cast<long long>(magnitude))
+        : static_cast<int>(magnitude);
+    return IntListStatus::OK;
+}
+
+/**
+ * Function: scan_int_list
+ * -----------------------
+ * Scans a list of integers separated by commas, semicolons or whitespace
+ * directly from the source text and appends the values to out.
+ *
+ * Each token is an optional sign followed by decimal digits and must fit
+ * into an int. Empty tokens ("1,,2") are skipped. The scan never throws
+ * and never allocates beyond growing out; on failure out is restored to
+ * the size it had on entry.
+ *
+ * Example:
+ *   "1, 2, 3"    → OK, out += {1, 2, 3}
+ *   "10; 20 30"  → OK, out += {10, 20, 30}
+ *   "1, a"       → INVALID_TOKEN
+ *   "3000000000" → OUT_OF_RANGE
+ *
+ * @param inside Text between the brackets
+ * @param out Buffer receiving the parsed values (any vector of int)
+ * @return IntListStatus::OK on success, otherwise the reason of the failure
+ *
+ * Complexity: CCN = 6, NLOC = 20
+ */
+template <class IntVector>
+static IntListStatus scan_int_list(std::string_view inside, IntVector& out) {
+    const size_t initialSize = out.size();
+    const size_t n = inside.size();
+    size_t i = 0;
+
+    while (i < n) {
+        // Skip separators between tokens
+        if (is_list_separator(inside[i])) {
+            i++;
+            continue;
+        }
+
+        // A token must be a number that ends at a separator
+        int value = 0;
+        IntListStatus status = scan_int(inside, i, value);
+        if (status == IntListStatus::OK && i < n && !is_list_separator(inside[i]))
+            status = IntListStatus::INVALID_TOKEN;
+        if (status != IntListStatus::OK) {
+            out.resize(initialSize);
+            return status;
+        }
+
+        out.push_back(value);
+    }
+    return IntListStatus::OK;
+}
+
+/**
+ * Function: parseIntListInto
+ * --------------------------
+ * Appends the integers of a list to a vector (see scan_int_list); one
+ * overload per vector type the parser fills.
+ *
+ * Complexity: CCN = 1, NLOC = 3
+ */
+IntListStatus parseIntListInto(std::string_view inside, std::vector<int>& out) {
+    return scan_int_list(inside, out);
+}
+
+IntListStatus parseIntListInto(std::string_view inside, std::pmr::vector<int>& out) {
+    return scan_int_list(inside, out);
+}
+
+IntListStatus parseIntListInto(std::string_view inside, IntList& out) {
+    return scan_int_list(inside, out);
 }
 
 /**
@@ -47,38 +189,14 @@ std::string trim(const std::string& s) {
  *   "[1, 2, 3]" → {1, 2, 3}
  *   "10; 20, 30" → {10, 20, 30}
  *
- * @param inside String containing comma or semicolon separated integers
- * @return Vector of parsed integers, empty vector if parsing fails
+ * @param inside Text containing comma or semicolon separated integers
+ * @return List of parsed integers, empty list if parsing fails
  *
- * Complexity: CCN = 8, NLOC = 21
+ * Complexity: CCN = 2, NLOC = 5
  */
-std::vector<int> parseIntList(const std::string& inside) {
-    std::vector<int> vals;
-    if (inside.empty()) return vals;
-
-    // Replace commas and semicolons with spaces for uniform parsing
-    std::string t = inside;
-    for (char& c : t)
-        if (c == ',' || c == ';') c = ' ';
-
-    // Parse space-separated integers
-    std::stringstream ss(t);
-    std::string token;
-    while (ss >> token) {
-        try {
-            size_t pos = 0;
-            int v = std::stoi(token, &pos);
-
-            // Ensure the entire token is numeric (no trailing characters)
-            if (pos != token.size()) return {};
-
-            vals.push_back(v);
-        }
-        catch (...) {
-            // If any token fails to parse, return empty vector
-            return {};
-        }
-    }
+IntList parseIntList(std::string_view inside) {
+    IntList vals;
+    if (parseIntListInto(inside, vals) != IntListStatus::OK) return {};
     return vals;
 }
 
@@ -86,6 +204,159 @@ std::vector<int> parseIntList(const std::string& inside) {
 // Record Parsing Function
 // ============================================================================
 
+/**
+ * Function: record_error
+ * ----------------------
+ * Stores a record parsing error with its 1-based column (0 if unknown)
+ * and returns false.
+ */
+static bool record_error(Error& error, ErrorCode code, size_t column) {
+    error = Error{ code, "Parser", column };
+    return false;
+}
+
+/**
+ * Function: parse_property_token
+ * ------------------------------
+ * Parses one "name = [values]" token of a record line and stores it in rec.
+ * The token is a view into the original line; the values are appended to
+ * the value buffer of rec and the property entry is inserted at its sorted
+ * position, so nothing is allocated per property (except for the name the
+ * first time the dictionary sees it).
+ *
+ * @param token Trimmed, non-empty property token
+ * @param eq Offset of the first '=' in token (npos if there is none)
+ * @param column 1-based column of the token in its line
+ * @param rec Record receiving the property
+ * @param error Receives the error if the token is invalid
+ * @return true if the property was added, false otherwise
+ *
+ * Complexity: CCN = 8, NLOC = 24
+ */
+static bool parse_property_token(std::string_view token, size_t eq, size_t column, Record& rec, Error& error) {
+    // Each property must have format: name = [values]
+    if (eq == std::string_view::npos)
+        return record_error(error, ErrorCode::INVALID_RECORD, column);
+
+    // Extract and validate property value (must be in brackets)
+    std::string_view val = trim_view(token.substr(eq + 1));
+    if (val.size() < 2 || val.front() != '[' || val.back() != ']')
+        return record_error(error, ErrorCode::INCORRECT_RULE, column + eq + 1);
+
+    // Property names are interned case-insensitively, so "Size" and
+    // "size" are the same property
+    PropertyId id = intern_property(trim_view(token.substr(0, eq)));
+
+    // Check for duplicate property names
+    auto hint = std::lower_bound(rec.properties.begin(), rec.properties.end(), id,
+        [](const PropertyEntry& entry, PropertyId key) { return entry.id < key; });
+    if (hint != rec.properties.end() && hint->id == id)
+        return record_error(error, ErrorCode::DUPLICATE_PROPERTY, column);
+
+    // Parse the integer list inside brackets straight into the value
+    // buffer of the record and validate that non-empty values were
+    // parsed correctly
+    std::string_view inside = val.substr(1, val.size() - 2);
+    const size_t offset = rec.values.size();
+    if (parseIntListInto(inside, rec.values) != IntListStatus::OK ||
+        (!inside.empty() && rec.values.size() == offset))
+        return record_error(error, ErrorCode::INVALID_NUMERIC_VALUE, column + (val.data() - token.data()));
+
+    // Add property to record
+    rec.properties.insert(hint, { id, static_cast<uint32_t>(offset),
+        static_cast<uint32_t>(rec.values.size() - offset) });
+    return true;
+}
+
+/**
+ * Function: parse_indexed_record
+ * ------------------------------
+ * Parses a record line whose structural characters (':', '=', '[', ']',
+ * ',') have already been located by find_structurals. The parser jumps
+ * from one structural position to the next instead of inspecting every
+ * byte: the first ':' separates the name, top-level ',' separate the
+ * property tokens and the first '=' of each token splits name and value.
+ *
+ * @param line Record line
+ * @param pos Ascending structural offsets covering exactly this line
+ * @param count Number of offsets in pos
+ * @param origin Value to subtract from each offset to make it relative to line
+ * @param rec Output Record object to populate
+ * @param error Receives the error if the line is invalid
+ * @return true if parsing successful, false otherwise
+ *
+ * Complexity: CCN = 16, NLOC = 50
+ */
+static bool parse_indexed_record(std::string_view line, const uint32_t* pos, size_t count,
+    size_t origin, Record& rec, Error& error) {
+    // Step 1: Validate line is not empty
+    if (line.empty())
+        return record_error(error, ErrorCode::INVALID_RECORD, 0);
+
+    // Step 2: Find colon separator between name and properties
+    size_t k = 0;
+    while (k < count && line[pos[k] - origin] != ':') k++;
+    if (k == count)
+        return record_error(error, ErrorCode::INVALID_RECORD, 0);
+    size_t colon = pos[k++] - origin;
+
+    // Step 3: Extract and validate record name
+    rec.name.assign(trim_view(line.substr(0, colon)));
+    if (rec.name.empty())
+        return record_error(error, ErrorCode::EMPTY_RECORD_NAME, 1);
+
+    // Step 4: Extract properties section
+    std::string_view propsPart = trim_view(line.substr(colon + 1));
+    if (propsPart.empty())
+        return record_error(error, ErrorCode::INVALID_RECORD, colon + 2);
+    const size_t propsEnd = (size_t)(propsPart.data() - line.data()) + propsPart.size();
+
+    // Properties are collected in per-thread scratch buffers and copied
+    // into rec once, at their final size
+    thread_local Record scratch;
+    scratch.properties.clear();
+    scratch.values.clear();
+
+    // Step 5: Walk the remaining structurals, splitting properties on
+    // top-level commas while respecting bracket nesting (values can
+    // contain commas: [1, 2, 3]), and parse each token
+    int depth = 0;                               // Track bracket nesting level
+    size_t start = colon + 1;                    // Start of the current token
+    size_t eq = std::string_view::npos;          // First '=' of the current token
+    for (; k <= count; k++) {
+        size_t p = propsEnd;
+        if (k < count && pos[k] - origin < propsEnd) {
+            p = pos[k] - origin;
+            char c = line[p];
+            if (c == '[') depth++;
+            else if (c == ']') depth--;
+            else if (c == '=' && eq == std::string_view::npos) eq = p;
+            if (c != ',' || depth != 0) continue;
+        }
+        else {
+            k = count;  // End of the properties section closes the last token
+        }
+
+        std::string_view token = trim_view(line.substr(start, p - start));
+        size_t tokenStart = (size_t)(token.data() - line.data());
+        size_t tokenEq = (eq == std::string_view::npos) ? eq : eq - tokenStart;
+        start = p + 1;
+        eq = std::string_view::npos;
+        if (token.empty()) continue;
+
+        if (!parse_property_token(token, tokenEq, tokenStart + 1, scratch, error))
+            return false;
+    }
+
+    // Final validation: record must have at least one property
+    if (scratch.properties.empty())
+        return record_error(error, ErrorCode::INVALID_RECORD, 0);
+
+    rec.properties.assign(scratch.properties.begin(), scratch.properties.end());
+    rec.values.assign(scratch.values.begin(), scratch.values.end());
+    return true;
+}
+
 /**
  * Function: parse_record_line
  * ---------------------------
@@ -104,349 +375,627 @@ std::vector<int> parseIntList(const std::string& inside) {
  * - Detection of duplicate properties
  * - Numeric value validation
  *
+ * The structural characters of the line are located with the SIMD
+ * scanner first; parse_indexed_record then works from that position list.
+ *
  * @param line Input line to parse
  * @param rec Output Record object to populate
  * @param errors Set to collect parsing errors
  * @return true if parsing successful, false otherwise
  *
- * Complexity: CCN = 23, NLOC = 84
- * Note: High complexity due to bracket-aware tokenization and multiple validations
+ * Complexity: CCN = 2, NLOC = 6
  */
-bool parse_record_line(const std::string& line, Record& rec, std::set<Error>& errors) {
-    // Step 1: Validate line is not empty
-    if (line.empty()) {
-        Error e{ ErrorCode::INVALID_RECORD, "Parser" };
-        errors.insert(e);
-        return false;
-    }
+bool parse_record_line(std::string_view line, Record& rec, std::set<Error>& errors) {
+    Error error{ ErrorCode::INVALID_RECORD, "Parser" };
+    if (parse_record_line(line, rec, error)) return true;
+    errors.insert(error);
+    return false;
+}
 
-    // Step 2: Find colon separator between name and properties
-    size_t colon = line.find(':');
-    if (colon == std::string::npos) {
-        Error e{ ErrorCode::INVALID_RECORD, "Parser" };
-        errors.insert(e);
-        return false;
-    }
+/**
+ * Function: parse_record_line
+ * ---------------------------
+ * Same as above, but returns the error of an invalid line instead of
+ * adding it to a set; used by the file-level parsers.
+ *
+ * @param line Input line to parse
+ * @param rec Output Record object to populate
+ * @param error Receives the error if the line is invalid
+ * @return true if parsing successful, false otherwise
+ *
+ * Complexity: CCN = 1, NLOC = 5
+ */
+bool parse_record_line(std::string_view line, Record& rec, Error& error) {
+    thread_local std::vector<uint32_t> positions;
+    positions.clear();
+    find_structurals(line, positions);
+    return parse_indexed_record(line, positions.data(), positions.size(), 0, rec, error);
+}
 
-    // Step 3: Extract and validate record name
-    rec.name = trim(line.substr(0, colon));
-    if (rec.name.empty()) {
-        Error e{ ErrorCode::EMPTY_RECORD_NAME, "Parser" };
-        errors.insert(e);
-        return false;
-    }
+// ============================================================================
+// Items File Parsing
+// ============================================================================
 
-    // Step 4: Extract properties section
-    std::string propsPart = trim(line.substr(colon + 1));
-    if (propsPart.empty()) {
-        Error e{ ErrorCode::INVALID_RECORD, "Parser" };
-        errors.insert(e);
-        return false;
-    }
+/*
+ * Inputs smaller than this are parsed on the calling thread: starting
+ * workers costs more than parsing a few thousand lines.
+ */
+static const size_t MIN_PARALLEL_CHUNK = 256 * 1024;
 
-    // Step 5: Tokenize properties while respecting bracket nesting
-    // This is necessary because property values can contain commas: [1, 2, 3]
-    std::vector<std::string> chunks;
-    std::string cur;
-    int depth = 0;  // Track bracket nesting level
-
-    for (char c : propsPart) {
-        // Track bracket depth to avoid splitting inside brackets
-        if (c == '[') depth++;
-        if (c == ']') depth--;
-
-        // Split on comma only at top level (depth == 0)
-        if (c == ',' && depth == 0) {
-            if (!cur.empty()) {
-                chunks.push_back(trim(cur));
-                cur.clear();
-            }
+/*
+ * Structure: RecordChunk
+ * ----------------------
+ * Slice of the items file parsed by one worker, with the worker's
+ * thread-local results.
+ */
+struct RecordChunk {
+    size_t index = 0;                       // Position of the chunk in the file
+    std::string_view text;                  // Newline-aligned slice of the file
+    size_t recordCount = 0;                 // Records parsed from the slice
+    size_t lineCount = 0;                   // Lines in the slice
+    ErrorSink errors;                       // Errors met in the slice (chunk line numbers)
+    std::vector<std::string_view> rejected; // Lines that failed to parse
+    std::pmr::memory_resource* memory = std::pmr::get_default_resource();  // Record memory
+};
+
+/*
+ * Structural characters are indexed one window of about this many bytes
+ * at a time (extended to the next line end), which keeps the position
+ * list in cache no matter how large the chunk is.
+ */
+static const size_t INDEX_WINDOW = 64 * 1024;
+
+/**
+ * Function: parse_record_chunk
+ * ----------------------------
+ * Sequentially parses all lines of one chunk, handing every record to
+ * consume as soon as it is parsed. Each window of the chunk is indexed
+ * once with find_structurals; the '\n' positions delimit the lines and
+ * the positions between them are handed to parse_indexed_record. Errors
+ * carry line numbers relative to the chunk.
+ *
+ * @param chunk Chunk to parse; errors and rejected lines are stored in it
+ * @param consume Receives each parsed record
+ *
+ * Complexity: CCN = 9, NLOC = 35
+ */
+static void parse_record_chunk(RecordChunk& chunk, const RecordConsumer& consume) {
+    std::string_view text = chunk.text;
+    std::vector<uint32_t> positions;
+
+    while (!text.empty()) {
+        // Cut the next window at a line boundary
+        size_t windowEnd = text.size();
+        if (windowEnd > INDEX_WINDOW) {
+            size_t nl = text.find('\n', INDEX_WINDOW);
+            if (nl != std::string_view::npos) windowEnd = nl + 1;
         }
-        else {
-            cur.push_back(c);
+        std::string_view window = text.substr(0, windowEnd);
+        text.remove_prefix(windowEnd);
+
+        positions.clear();
+        find_structurals(window, positions);
+
+        // Walk the lines of the window; [first, j) are the line's structurals
+        size_t lineStart = 0, first = 0;
+        for (size_t j = 0; j <= positions.size(); j++) {
+            if (j < positions.size() && window[positions[j]] != '\n') continue;
+            size_t lineEnd = (j < positions.size()) ? positions[j] : window.size();
+            if (lineStart >= lineEnd && j == positions.size()) break;
+
+            std::string_view clean = trim_view(window.substr(lineStart, lineEnd - lineStart));
+            size_t begin = first;
+            size_t indent = (size_t)(clean.data() - window.data()) - lineStart;
+            lineStart = lineEnd + 1;
+            first = j + 1;
+            chunk.lineCount++;
+
+            // Skip empty lines
+            if (clean.empty()) continue;
+
+            Record r{ Record::allocator_type(chunk.memory) };
+            Error error;
+            size_t origin = (size_t)(clean.data() - window.data());
+            if (parse_indexed_record(clean, positions.data() + begin, j - begin, origin, r, error)) {
+                chunk.recordCount++;
+                consume(chunk.index, r);
+            }
+            else {
+                // Report the column within the untrimmed line
+                if (error.column > 0) error.column += indent;
+                chunk.errors.report(error, chunk.lineCount);
+                chunk.rejected.push_back(clean);
+            }
         }
     }
+}
 
-    // Don't forget the last token
-    if (!cur.empty()) chunks.push_back(trim(cur));
+/**
+ * Function: record_chunk_count
+ * ----------------------------
+ * Number of chunks stream_records splits the text into.
+ *
+ * @param text Whole contents of the items file
+ * @param threads Maximum number of worker threads (0 = hardware concurrency)
+ * @return Chunk count, at least 1
+ *
+ * Complexity: CCN = 2, NLOC = 4
+ */
+size_t record_chunk_count(std::string_view text, unsigned threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    return std::min<size_t>(threads, text.size() / MIN_PARALLEL_CHUNK + 1);
+}
 
-    // Validate we have at least one property
-    if (chunks.empty()) {
-        Error e{ ErrorCode::INVALID_RECORD, "Parser" };
-        errors.insert(e);
-        return false;
+/**
+ * Function: stream_records
+ * ------------------------
+ * Splits the items text into newline-aligned chunks and parses them in
+ * parallel, passing each record to consume instead of storing it.
+ * Per-chunk errors and rejected lines are merged in input order.
+ *
+ * @param text Whole contents of the items file
+ * @param errors Sink collecting parsing errors with their line numbers
+ * @param rejected Output list of lines that failed to parse
+ * @param threads Maximum number of worker threads (0 = hardware concurrency)
+ * @param consume Receives (chunk index, record) for every parsed record
+ * @param arena Memory for the records, one resource per chunk (nullptr =
+ *              default resource)
+ * @return Number of successfully parsed records
+ *
+ * Complexity: CCN = 8, NLOC = 33
+ */
+size_t stream_records(std::string_view text, ErrorSink& errors,
+    std::vector<std::string_view>& rejected, unsigned threads, const RecordConsumer& consume,
+    RecordArena* arena) {
+    size_t chunkCount = record_chunk_count(text, threads);
+    if (arena != nullptr)
+        arena->prepare(chunkCount, text.size() / chunkCount);
+
+    // Step 1: Cut the text at the first newline after each ideal boundary
+    std::vector<RecordChunk> chunks(chunkCount);
+    size_t begin = 0;
+    for (size_t i = 0; i < chunkCount; i++) {
+        size_t end = text.size();
+        if (i + 1 < chunkCount) {
+            end = std::max(begin, text.size() * (i + 1) / chunkCount);
+            end = text.find('\n', end);
+            end = (end == std::string_view::npos) ? text.size() : end + 1;
+        }
+        chunks[i].index = i;
+        chunks[i].text = text.substr(begin, end - begin);
+        chunks[i].errors = ErrorSink(errors.examplesPerCode());
+        chunks[i].errors.setFile(errors.file());
+        if (arena != nullptr) chunks[i].memory = arena->chunk(i);
+        begin = end;
     }
 
-    // Step 6: Parse each property token
-    for (const auto& token : chunks) {  // ✅ Fixed: added const
-        if (token.empty()) continue;
-
-        // Each property must have format: name = [values]
-        size_t eq = token.find('=');
-        if (eq == std::string::npos) {
-            Error e{ ErrorCode::INVALID_RECORD, "Parser" };
-            errors.insert(e);
-            return false;
-        }
+    // Step 2: Parse the chunks; the first one runs on the calling thread
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < chunkCount; i++)
+        workers.emplace_back(parse_record_chunk, std::ref(chunks[i]), std::cref(consume));
+    parse_record_chunk(chunks[0], consume);
+    for (auto& w : workers)
+        w.join();
+
+    // Step 3: Merge thread-local diagnostics in input order, turning
+    // chunk line numbers into file line numbers
+    size_t total = 0, lines = 0;
+    for (auto& c : chunks) {
+        total += c.recordCount;
+        errors.merge(c.errors, lines);
+        lines += c.lineCount;
+        rejected.insert(rejected.end(), c.rejected.begin(), c.rejected.end());
+    }
+    return total;
+}
 
-        // Extract property name and convert to lowercase for consistency
-        std::string pname = trim(token.substr(0, eq));
-        std::transform(pname.begin(), pname.end(), pname.begin(),
-            [](unsigned char c) { return std::tolower(c); });
+/**
+ * Function: parse_records
+ * -----------------------
+ * Parses the items text in parallel chunks and concatenates the
+ * per-chunk records in input order.
+ *
+ * @param text Whole contents of the items file
+ * @param records Output vector of parsed records
+ * @param errors Sink collecting parsing errors
+ * @param rejected Output list of lines that failed to parse
+ * @param threads Maximum number of worker threads (0 = hardware concurrency)
+ * @param arena Memory for the records (nullptr = default resource)
+ *
+ * Complexity: CCN = 5, NLOC = 18
+ */
+void parse_records(std::string_view text, std::vector<Record>& records, ErrorSink& errors,
+    std::vector<std::string_view>& rejected, unsigned threads, RecordArena* arena) {
+    // Thread-local record vectors, one per chunk; moving a record keeps
+    // its memory in the arena of its chunk
+    std::vector<std::vector<Record>> parts(record_chunk_count(text, threads));
+    size_t total = stream_records(text, errors, rejected, threads,
+        [&parts](size_t chunk, Record& rec) { parts[chunk].push_back(std::move(rec)); }, arena);
+
+    // Merge in input order (a single part is taken over without a copy
+    // of the record headers)
+    if (records.empty() && parts.size() == 1) {
+        records.swap(parts[0]);
+        return;
+    }
+    records.reserve(records.size() + total);
+    for (auto& part : parts)
+        std::move(part.begin(), part.end(), std::back_inserter(records));
+}
 
-        // Extract and validate property value (must be in brackets)
-        std::string val = trim(token.substr(eq + 1));
-        if (val.size() < 2 || val.front() != '[' || val.back() != ']') {
-            Error e{ ErrorCode::INCORRECT_RULE, "Parser" };
-            errors.insert(e);
-            return false;
-        }
+// ============================================================================
+// Rule Parsing Function
+// ============================================================================
 
-        // Parse the integer list inside brackets
-        std::string inside = val.substr(1, val.size() - 2);
-        Property p{ pname, parseIntList(inside) };
+/*
+ * Enum: RuleTokenType
+ * -------------------
+ * Lexical categories of the rule language.
+ */
+enum class RuleTokenType {
+    KEYWORD,    // Known keyword (see RuleKeyword)
+    WORD,       // Any other run of letters
+    STRING,     // "quoted property name"
+    NUMBER,     // Optionally signed decimal integer
+    EQUALS,     // =
+    LBRACKET,   // [
+    RBRACKET,   // ]
+    SEPARATOR,  // , or ;
+    END,        // End of the line
+    INVALID     // Unterminated string, out-of-range number or stray character
+};
+
+/*
+ * Enum: RuleKeyword
+ * -----------------
+ * Keywords of the rule language; English and Russian spellings map
+ * to the same keyword.
+ */
+enum class RuleKeyword {
+    NONE,
+    HAS,       // has          / есть, имеет
+    PROPERTY,  // property     / свойство
+    CONTAINS,  // contains     / содержит
+    VALUE,     // value        / значение
+    VALUES     // values       / значений, значения
+};
+
+/*
+ * Structure: RuleToken
+ * --------------------
+ * One token of a rule description.
+ *
+ * Fields:
+ *   - type    : lexical category.
+ *   - keyword : keyword identity for KEYWORD tokens.
+ *   - text    : token text (without quotes for STRING).
+ *   - value   : numeric value for NUMBER tokens.
+ *   - pos     : offset of the token in the rule line.
+ *   - error   : error code for INVALID tokens.
+ */
+struct RuleToken {
+    RuleTokenType type = RuleTokenType::END;
+    RuleKeyword keyword = RuleKeyword::NONE;
+    std::string_view text;
+    int value = 0;
+    size_t pos = 0;
+    ErrorCode error = ErrorCode::SYNTAX_ERROR_IN_CLASS_RULE;
+};
+
+/*
+ * Function: lookup_rule_keyword
+ * -----------------------------
+ * Maps a word to its keyword (NONE if it is not a keyword).
+ */
+static RuleKeyword lookup_rule_keyword(std::string_view word) {
+    static const struct { const char* text; RuleKeyword keyword; } table[] = {
+        { "has", RuleKeyword::HAS },           { "есть", RuleKeyword::HAS },
+        { "имеет", RuleKeyword::HAS },
+        { "property", RuleKeyword::PROPERTY }, { "свойство", RuleKeyword::PROPERTY },
+        { "contains", RuleKeyword::CONTAINS }, { "содержит", RuleKeyword::CONTAINS },
+        { "value", RuleKeyword::VALUE },       { "значение", RuleKeyword::VALUE },
+        { "values", RuleKeyword::VALUES },     { "значений", RuleKeyword::VALUES },
+        { "значения", RuleKeyword::VALUES },
+    };
+    for (const auto& k : table)
+        if (word == k.text) return k.keyword;
+    return RuleKeyword::NONE;
+}
 
-        // Check for duplicate property names
-        if (rec.properties.count(pname)) {
-            Error e{ ErrorCode::DUPLICATE_PROPERTY, "Parser" };
-            errors.insert(e);
-            return false;
+/*
+ * Class: RuleLexer
+ * ----------------
+ * Single-pass tokenizer for rule descriptions. Tokens are produced on
+ * demand by next(), each character of the line is read exactly once.
+ * Words are runs of ASCII letters, '_' and non-ASCII (UTF-8) bytes.
+ */
+class RuleLexer {
+public:
+    RuleLexer(std::string_view line, size_t start) : line_(line), i_(start) {}
+
+    RuleToken next() {
+        const size_t n = line_.size();
+        while (i_ < n && std::isspace((unsigned char)line_[i_])) i_++;
+
+        RuleToken t;
+        t.pos = i_;
+        if (i_ == n) return t;  // END
+
+        unsigned char c = (unsigned char)line_[i_];
+        if (c == '"') {
+            size_t close = line_.find('"', i_ + 1);
+            if (close == std::string_view::npos) {
+                t.type = RuleTokenType::INVALID;
+                t.error = ErrorCode::MISSING_QUOTE;
+                i_ = n;
+                return t;
+            }
+            t.type = RuleTokenType::STRING;
+            t.text = line_.substr(i_ + 1, close - i_ - 1);
+            i_ = close + 1;
         }
-
-        // Validate that non-empty values were parsed correctly
-        if (!inside.empty() && p.values.empty()) {
-            Error e{ ErrorCode::INVALID_NUMERIC_VALUE, "Parser" };
-            errors.insert(e);
-            return false;
+        else if (std::isdigit(c) || ((c == '-' || c == '+') && i_ + 1 < n &&
+            std::isdigit((unsigned char)line_[i_ + 1]))) {
+            size_t start = i_;
+            IntListStatus status = scan_int(line_, i_, t.value);
+            if (status != IntListStatus::OK) {
+                while (i_ < n && std::isdigit((unsigned char)line_[i_])) i_++;
+                t.type = RuleTokenType::INVALID;
+                t.error = ErrorCode::INVALID_NUMERIC_VALUE;
+            }
+            else {
+                t.type = RuleTokenType::NUMBER;
+            }
+            t.text = line_.substr(start, i_ - start);
         }
-
-        // Add property to record
-        rec.properties[pname] = p;
+        else if (std::isalpha(c) || c == '_' || c >= 0x80) {
+            size_t start = i_;
+            while (i_ < n) {
+                unsigned char w = (unsigned char)line_[i_];
+                if (!(std::isalpha(w) || w == '_' || w >= 0x80)) break;
+                i_++;
+            }
+            t.text = line_.substr(start, i_ - start);
+            t.keyword = lookup_rule_keyword(t.text);
+            t.type = (t.keyword == RuleKeyword::NONE) ? RuleTokenType::WORD : RuleTokenType::KEYWORD;
+        }
+        else {
+            t.text = line_.substr(i_, 1);
+            i_++;
+            switch (c) {
+            case '=': t.type = RuleTokenType::EQUALS; break;
+            case '[': t.type = RuleTokenType::LBRACKET; break;
+            case ']': t.type = RuleTokenType::RBRACKET; break;
+            case ',': case ';': t.type = RuleTokenType::SEPARATOR; break;
+            default:  t.type = RuleTokenType::INVALID; break;
+            }
+        }
+        return t;
     }
 
-    // Final validation: record must have at least one property
-    if (rec.properties.empty()) {
-        Error e{ ErrorCode::INVALID_RECORD, "Parser" };
-        errors.insert(e);
-        return false;
-    }
+private:
+    std::string_view line_;
+    size_t i_;
+};
 
-    return true;
+/**
+ * Function: rule_error
+ * --------------------
+ * Records a rule parsing error at the given offset of the line
+ * (reported as a 1-based column) and returns false.
+ */
+static bool rule_error(Error& error, ErrorCode code, size_t pos) {
+    error = Error{ code, "Parser", pos + 1 };
+    return false;
 }
 
-// ============================================================================
-// Rule Parsing Function
-// ============================================================================
+/**
+ * Function: is_keyword
+ * --------------------
+ * True if t is the given keyword.
+ */
+static inline bool is_keyword(const RuleToken& t, RuleKeyword k) {
+    return t.type == RuleTokenType::KEYWORD && t.keyword == k;
+}
+
+/**
+ * Function: is_unsigned_number
+ * ----------------------------
+ * True if t is a NUMBER written without a sign. The operands of "has N
+ * values" and "contains value X" are unsigned; only the lists of '='
+ * may hold signed values.
+ */
+static inline bool is_unsigned_number(const RuleToken& t) {
+    return t.type == RuleTokenType::NUMBER && std::isdigit((unsigned char)t.text[0]);
+}
 
 /**
  * Function: parse_class_line
  * --------------------------
  * Parses a class rule definition line from the input file.
  *
- * Supported rule patterns:
- *   1. HAS_PROPERTY:      has property "name"
- *   2. PROPERTY_SIZE:     property "name" has N values
- *   3. CONTAINS_VALUE:    property "name" contains value X
- *   4. EQUALS_EXACTLY:    property "name" = [a, b, c]
+ * Grammar (keywords in English or Russian):
+ *   line     := NAME ':' rule END
+ *   rule     := "has" "property" STRING                        HAS_PROPERTY
+ *             | ["property"] STRING "has" DIGITS "values"        PROPERTY_SIZE
+ *             | ["property"] STRING "contains" "value" DIGITS    CONTAINS_VALUE
+ *             | ["property"] STRING '=' '[' list ']'             EQUALS_EXACTLY
+ *   list     := (NUMBER | ',' | ';')*
+ *
+ * DIGITS is an unsigned NUMBER, and the size must be followed by the
+ * plural "values" even for 1, as before the lexer. Russian spellings:
+ * есть свойство, свойство, имеет N значений (or значения), содержит
+ * значение.
  *
  * Examples:
  *   "Blue: has property \"color\""
  *   "Large: property \"size\" has 3 values"
  *   "Red: property \"color\" contains value 1"
  *   "Exact: property \"dims\" = [10, 20, 30]"
+ *   "Синий: свойство \"color\" содержит значение 1"
  *
- * This function:
- * - Identifies the rule type from keywords
- * - Extracts the property name from quotes
- * - Parses type-specific parameters (size, value, list)
- * - Validates all extracted data
+ * The description is read once by RuleLexer and parsed by recursive
+ * descent with one token of lookahead. Errors carry the column of the
+ * offending token.
  *
  * @param line Input line to parse
  * @param cr Output ClassRule object to populate
- * @param errors Set to collect parsing errors
+ * @param error Receives the error if the line is invalid
  * @return true if parsing successful, false otherwise
  *
- * Complexity: CCN = 35, NLOC = 105
- * Note: High complexity due to 4 distinct rule types, each with different parsing logic
- *       Cannot be easily refactored without losing cohesion
+ * Complexity: CCN = 24, NLOC = 80
  */
-bool parse_class_line(const std::string& line, ClassRule& cr, std::set<Error>& errors) {
+bool parse_class_line(std::string_view line, ClassRule& cr, Error& error) {
     // Step 1: Find colon separator between class name and rule description
     size_t colon = line.find(':');
-    if (colon == std::string::npos) {
-        Error e{ ErrorCode::INCORRECT_RULE, "Parser" };
-        errors.insert(e);
-        return false;
-    }
-
-    // Step 2: Extract class name and rule description
-    cr.className = trim(line.substr(0, colon));
-    std::string desc = trim(line.substr(colon + 1));
+    if (colon == std::string_view::npos)
+        return rule_error(error, ErrorCode::INCORRECT_RULE, line.size());
 
-    // Step 3: Validate class name is not empty
-    if (cr.className.empty()) {
-        Error e{ ErrorCode::EMPTY_CLASS_NAME, "Parser" };
-        errors.insert(e);
-        return false;
-    }
+    // Step 2: Extract and validate class name
+    cr.className.assign(trim_view(line.substr(0, colon)));
+    if (cr.className.empty())
+        return rule_error(error, ErrorCode::EMPTY_CLASS_NAME, 0);
 
-    // Step 4: Initialize rule object
+    RuleLexer lex(line, colon + 1);
+    RuleToken t = lex.next();
     Rule r;
 
-    // ========================================================================
-    // Rule Type 1: HAS_PROPERTY
-    // Pattern: "has property \"name\"" or Russian "есть свойство \"name\""
-    // Checks if a record has a specific property (regardless of its value)
-    // ========================================================================
-    if (desc.find("has property") != std::string::npos ||
-        desc.find("есть свойство") != std::string::npos) {
+    // Step 3: "has property NAME" (HAS_PROPERTY)
+    if (is_keyword(t, RuleKeyword::HAS)) {
+        t = lex.next();
+        if (!is_keyword(t, RuleKeyword::PROPERTY))
+            return rule_error(error, ErrorCode::UNKNOWN_RULE_TYPE, t.pos);
+        t = lex.next();
+        if (t.type != RuleTokenType::STRING)
+            return rule_error(error, ErrorCode::MISSING_QUOTE, t.pos);
 
         r.type = HAS_PROPERTY;
-
-        // Extract property name from quotes
-        size_t q1 = desc.find("\""), q2 = desc.find_last_of("\"");
-        if (q1 == std::string::npos || q2 == std::string::npos || q2 <= q1) {
-            Error e{ ErrorCode::MISSING_QUOTE, "Parser" };
-            errors.insert(e);
-            return false;
-        }
-
-        r.propertyName = desc.substr(q1 + 1, q2 - q1 - 1);
+        r.setProperty(t.text);
     }
 
-    // ========================================================================
-    // Rule Type 2: PROPERTY_SIZE
-    // Pattern: "property \"name\" has N values"
-    // Checks if a property has exactly N values
-    // ========================================================================
-    else if (desc.find("has") != std::string::npos &&
-        desc.find("values") != std::string::npos) {
-
-        r.type = PROPERTY_SIZE;
-
-        // Extract property name from quotes
-        size_t q1 = desc.find("\""), q2 = desc.find_last_of("\"");
-        if (q1 == std::string::npos || q2 == std::string::npos || q2 <= q1) {
-            Error e{ ErrorCode::MISSING_QUOTE, "Parser" };
-            errors.insert(e);
-            return false;
+    // Step 4: "[property] NAME ..." (PROPERTY_SIZE, CONTAINS_VALUE, EQUALS_EXACTLY)
+    else if (is_keyword(t, RuleKeyword::PROPERTY) || t.type == RuleTokenType::STRING) {
+        if (t.type != RuleTokenType::STRING)
+            t = lex.next();
+        if (t.type != RuleTokenType::STRING)
+            return rule_error(error, t.type == RuleTokenType::INVALID ? t.error : ErrorCode::MISSING_QUOTE, t.pos);
+        r.setProperty(t.text);
+
+        t = lex.next();
+        if (is_keyword(t, RuleKeyword::HAS)) {
+            // PROPERTY_SIZE: has N values
+            r.type = PROPERTY_SIZE;
+            t = lex.next();
+            if (!is_unsigned_number(t) || t.value <= 0)
+                return rule_error(error, ErrorCode::INVALID_NUMERIC_VALUE, t.pos);
+            r.expectedSize = t.value;
+            t = lex.next();
+            if (!is_keyword(t, RuleKeyword::VALUES))
+                return rule_error(error, ErrorCode::UNKNOWN_RULE_TYPE, t.pos);
         }
-
-        r.propertyName = desc.substr(q1 + 1, q2 - q1 - 1);
-
-        // Extract the expected size (first digit sequence found)
-        for (size_t i = 0; i < desc.size(); i++) {
-            if (isdigit((unsigned char)desc[i])) {
-                r.expectedSize = stoi(desc.substr(i));
-                break;
+        else if (is_keyword(t, RuleKeyword::CONTAINS)) {
+            // CONTAINS_VALUE: contains value X
+            r.type = CONTAINS_VALUE;
+            t = lex.next();
+            if (!is_keyword(t, RuleKeyword::VALUE))
+                return rule_error(error, ErrorCode::INCORRECT_RULE, t.pos);
+            t = lex.next();
+            if (!is_unsigned_number(t))
+                return rule_error(error, ErrorCode::INVALID_NUMERIC_VALUE, t.pos);
+            r.expectedValue = t.value;
+        }
+        else if (t.type == RuleTokenType::EQUALS) {
+            // EQUALS_EXACTLY: = [a, b, c]
+            r.type = EQUALS_EXACTLY;
+            t = lex.next();
+            if (t.type != RuleTokenType::LBRACKET)
+                return rule_error(error, ErrorCode::INCORRECT_RULE, t.pos);
+            for (t = lex.next(); t.type != RuleTokenType::RBRACKET; t = lex.next()) {
+                if (t.type == RuleTokenType::NUMBER)
+                    r.expectedExactValues.push_back(t.value);
+                else if (t.type == RuleTokenType::END)
+                    return rule_error(error, ErrorCode::INCORRECT_RULE, t.pos);
+                else if (t.type != RuleTokenType::SEPARATOR)
+                    return rule_error(error, ErrorCode::INVALID_NUMERIC_VALUE, t.pos);
             }
+            if (r.expectedExactValues.empty())
+                return rule_error(error, ErrorCode::INVALID_NUMERIC_VALUE, t.pos);
         }
-
-        // Validate size is positive
-        if (r.expectedSize <= 0) {
-            Error e{ ErrorCode::INVALID_NUMERIC_VALUE, "Parser" };
-            errors.insert(e);
-            return false;
+        else {
+            return rule_error(error, ErrorCode::UNKNOWN_RULE_TYPE, t.pos);
         }
     }
 
-    // ========================================================================
-    // Rule Type 3: CONTAINS_VALUE
-    // Pattern: "property \"name\" contains value X"
-    // Checks if a property's value list contains a specific integer
-    // ========================================================================
-    else if (desc.find("contains value") != std::string::npos ||
-        desc.find("содержит значение") != std::string::npos) {
-
-        r.type = CONTAINS_VALUE;
-
-        // Extract property name from quotes
-        size_t q1 = desc.find("\""), q2 = desc.find_last_of("\"");
-        if (q1 == std::string::npos || q2 == std::string::npos || q2 <= q1) {
-            Error e{ ErrorCode::MISSING_QUOTE, "Parser" };
-            errors.insert(e);
-            return false;
-        }
-
-        r.propertyName = desc.substr(q1 + 1, q2 - q1 - 1);
-
-        // Find "value" keyword and extract the number after it
-        size_t pos = desc.find("value");
-        if (pos == std::string::npos) {
-            Error e{ ErrorCode::INCORRECT_RULE, "Parser" };
-            errors.insert(e);
-            return false;
-        }
-
-        std::string afterValue = trim(desc.substr(pos + 5));
-        if (afterValue.empty()) {
-            Error e{ ErrorCode::INVALID_NUMERIC_VALUE, "Parser" };
-            errors.insert(e);
-            return false;
-        }
-
-        // Validate that afterValue contains only digits and spaces
-        for (char c : afterValue) {
-            if (!isdigit((unsigned char)c) && c != ' ') {
-                Error e{ ErrorCode::INVALID_NUMERIC_VALUE, "Parser" };
-                errors.insert(e);
-                return false;
-            }
-        }
-
-        r.expectedValue = stoi(afterValue);
+    // Unknown rule type: none of the patterns start with this token
+    else {
+        return rule_error(error, t.type == RuleTokenType::INVALID ? t.error : ErrorCode::UNKNOWN_RULE_TYPE, t.pos);
     }
 
-    // ========================================================================
-    // Rule Type 4: EQUALS_EXACTLY
-    // Pattern: "property \"name\" = [a, b, c]"
-    // Checks if a property's value list exactly matches a given list
-    // ========================================================================
-    else if (desc.find("=") != std::string::npos &&
-        desc.find("[") != std::string::npos) {
-
-        r.type = EQUALS_EXACTLY;
-
-        // Extract property name from quotes
-        size_t q1 = desc.find("\""), q2 = desc.find_last_of("\"");
-        if (q1 == std::string::npos || q2 == std::string::npos || q2 <= q1) {
-            Error e{ ErrorCode::MISSING_QUOTE, "Parser" };
-            errors.insert(e);
-            return false;
-        }
-
-        r.propertyName = desc.substr(q1 + 1, q2 - q1 - 1);
+    // Step 5: Nothing may follow a complete rule
+    t = lex.next();
+    if (t.type != RuleTokenType::END)
+        return rule_error(error, ErrorCode::SYNTAX_ERROR_IN_CLASS_RULE, t.pos);
 
-        // Extract the list of values between brackets
-        size_t lb = desc.find("["), rb = desc.find("]");
-        if (lb == std::string::npos || rb == std::string::npos || rb <= lb) {
-            Error e{ ErrorCode::INCORRECT_RULE, "Parser" };
-            errors.insert(e);
-            return false;
-        }
+    // Step 6: Add the parsed rule to the class
+    cr.rules.push_back(std::move(r));
+    return true;
+}
 
-        std::string inside = desc.substr(lb + 1, rb - lb - 1);
-        r.expectedExactValues = parseIntList(inside);
+/**
+ * Function: parse_class_line
+ * --------------------------
+ * Same as above, but adds the error of an invalid line to a set.
+ *
+ * @param line Input line to parse
+ * @param cr Output ClassRule object to populate
+ * @param errors Set to collect parsing errors
+ * @return true if parsing successful, false otherwise
+ *
+ * Complexity: CCN = 2, NLOC = 6
+ */
+bool parse_class_line(std::string_view line, ClassRule& cr, std::set<Error>& errors) {
+    Error error{ ErrorCode::INCORRECT_RULE, "Parser" };
+    if (parse_class_line(line, cr, error)) return true;
+    errors.insert(error);
+    return false;
+}
 
-        // Validate that the list is not empty
-        if (r.expectedExactValues.empty()) {
-            Error e{ ErrorCode::INVALID_NUMERIC_VALUE, "Parser" };
-            errors.insert(e);
-            return false;
+/**
+ * Function: parse_rules
+ * ---------------------
+ * Parses a rules file line by line. Each rejected line is reported to
+ * errors and listed in rejected with its code and column.
+ *
+ * @param text Contents of the rules file
+ * @param classes Receives the parsed classes
+ * @param errors Sink collecting parsing errors
+ * @param rejected Receives the rejected lines
+ *
+ * Complexity: CCN = 4, NLOC = 22
+ */
+void parse_rules(std::string_view text, std::vector<ClassRule>& classes, ErrorSink& errors,
+    std::vector<RuleDiagnostic>& rejected) {
+    std::string_view line;
+    size_t lineNo = 0;
+    while (next_line(text, line)) {
+        lineNo++;
+
+        // Skip empty lines
+        std::string_view clean = trim_view(line);
+        if (clean.empty()) continue;
+
+        ClassRule cr;
+        Error error;
+        if (!parse_class_line(clean, cr, error)) {
+            // Report the column within the untrimmed line
+            if (error.column > 0)
+                error.column += static_cast<size_t>(clean.data() - line.data());
+            rejected.push_back({ lineNo, error.column, error.code, clean });
+            errors.report(error, lineNo);
+            continue; // Continue processing remaining rules
         }
-    }
 
-    // ========================================================================
-    // Unknown Rule Type
-    // If none of the patterns match, the rule format is invalid
-    // ========================================================================
-    else {
-        Error e{ ErrorCode::UNKNOWN_RULE_TYPE, "Parser" };
-        errors.insert(e);
-        return false;
+        classes.push_back(std::move(cr));
     }
-
-    // Step 5: Add the parsed rule to the class
-    cr.rules.push_back(r);
-    return true;
-}
\ No newline at end of file
+}
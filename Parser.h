@@ -1,10 +1,15 @@
 ﻿#pragma once
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory_resource>
 #include "Record.h"
+#include "RecordArena.h"
 #include "Rule.h"
 #include "Error.h"
+#include "ErrorSink.h"
 #include <set>
+#include <functional>
 
 /*
  * Function: trim
@@ -13,12 +18,47 @@
  */
 std::string trim(const std::string& s);
 
+/*
+ * Function: trim_view
+ * -------------------
+ * Same as trim, but returns a view into the input instead of a copy.
+ */
+std::string_view trim_view(std::string_view s);
+
+/*
+ * Enum: IntListStatus
+ * -------------------
+ * Result of scanning an integer list with parseIntListInto.
+ *
+ * Possible values:
+ *   - OK            : all tokens were valid integers.
+ *   - INVALID_TOKEN : a token is not an optionally signed decimal number.
+ *   - OUT_OF_RANGE  : a token does not fit into an int.
+ */
+enum class IntListStatus {
+    OK,
+    INVALID_TOKEN,
+    OUT_OF_RANGE
+};
+
+/*
+ * Function: parseIntListInto
+ * --------------------------
+ * Scans a list of integers in place and appends them to out.
+ * Reports failures through the return value instead of exceptions;
+ * out is left unchanged on failure.
+ */
+IntListStatus parseIntListInto(std::string_view inside, std::vector<int>& out);
+IntListStatus parseIntListInto(std::string_view inside, std::pmr::vector<int>& out);
+IntListStatus parseIntListInto(std::string_view inside, IntList& out);
+
 /*
  * Function: parseIntList
  * ----------------------
  * Parses a list of integers inside square brackets.
+ * Returns an empty list if any value is invalid.
  */
-std::vector<int> parseIntList(const std::string& inside);
+IntList parseIntList(std::string_view inside);
 
 /*
  * Function: parse_record_line
@@ -28,8 +68,73 @@ std::vector<int> parseIntList(const std::string& inside);
  *   "Table: color = [1, 4], size = [20, 40]"
  *
  * Now includes error tracking via std::set<Error>& errors.
+ * The line is parsed in place; only the stored record data is allocated.
  */
-bool parse_record_line(const std::string& line, Record& rec, std::set<Error>& errors);
+bool parse_record_line(std::string_view line, Record& rec, std::set<Error>& errors);
+
+/*
+ * Function: parse_record_line
+ * ---------------------------
+ * Same as above, but an invalid line's error (with the column of the
+ * offending token) is returned in error instead of added to a set.
+ */
+bool parse_record_line(std::string_view line, Record& rec, Error& error);
+
+/*
+ * Type: RecordConsumer
+ * --------------------
+ * Callback receiving each record parsed by stream_records together with
+ * the index of the chunk it came from. Called concurrently for different
+ * chunks and in line order within one chunk; the record may be moved from.
+ */
+using RecordConsumer = std::function<void(size_t chunk, Record& record)>;
+
+/*
+ * Function: record_chunk_count
+ * ----------------------------
+ * Number of chunks (and so at most worker threads) stream_records and
+ * parse_records use for this text; chunk indices are below this value.
+ */
+size_t record_chunk_count(std::string_view text, unsigned threads);
+
+/*
+ * Function: stream_records
+ * ------------------------
+ * Parses the items text in parallel newline-aligned chunks like
+ * parse_records, but hands each record to consume as soon as it is
+ * parsed instead of storing it, so memory does not grow with the file.
+ * With an arena, each chunk allocates its records from its own arena
+ * resource (the arena is prepared for the chunks of this text).
+ *
+ * Returns:
+ *   the number of successfully parsed records.
+ */
+size_t stream_records(std::string_view text, ErrorSink& errors,
+    std::vector<std::string_view>& rejected, unsigned threads, const RecordConsumer& consume,
+    RecordArena* arena = nullptr);
+
+/*
+ * Function: parse_records
+ * -----------------------
+ * Parses every non-blank line of an items file with parse_record_line.
+ *
+ * The text is split into newline-aligned chunks that are parsed on up to
+ * `threads` worker threads (0 = hardware concurrency), each with its own
+ * record vector and error sink. Results are merged in chunk order, so
+ * records and rejected lines come out in the same order as a sequential
+ * parse.
+ *
+ * Parameters:
+ *   - text     : whole contents of the items file.
+ *   - records  : receives the successfully parsed records, in line order.
+ *   - errors   : receives the parsing errors with their line numbers.
+ *   - rejected : receives the trimmed lines that failed to parse, in line order.
+ *   - threads  : maximum number of worker threads.
+ *   - arena    : if set, the records are allocated from it and must be
+ *                destroyed before it is released.
+ */
+void parse_records(std::string_view text, std::vector<Record>& records, ErrorSink& errors,
+    std::vector<std::string_view>& rejected, unsigned threads = 1, RecordArena* arena = nullptr);
 
 /*
  * Function: parse_class_line
@@ -44,4 +149,44 @@ bool parse_record_line(const std::string& line, Record& rec, std::set<Error>& er
  *   true  if the line is valid and parsed successfully,
  *   false otherwise.
  */
-bool parse_class_line(const std::string& line, ClassRule& cr, std::set<Error>& errors);
\ No newline at end of file
+bool parse_class_line(std::string_view line, ClassRule& cr, std::set<Error>& errors);
+
+/*
+ * Function: parse_class_line
+ * --------------------------
+ * Same as above, but an invalid line's error (with the column of the
+ * offending token) is returned in error instead of added to a set.
+ */
+bool parse_class_line(std::string_view line, ClassRule& cr, Error& error);
+
+/*
+ * Structure: RuleDiagnostic
+ * -------------------------
+ * A rules file line rejected by parse_class_line.
+ *
+ * Fields:
+ *   - line   : 1-based line number in the rules file.
+ *   - column : 1-based column of the offending token (0 if unknown).
+ *   - code   : reason of the rejection.
+ *   - text   : the trimmed line (a view into the rules text).
+ */
+struct RuleDiagnostic {
+    size_t line = 0;
+    size_t column = 0;
+    ErrorCode code = ErrorCode::INCORRECT_RULE;
+    std::string_view text;
+};
+
+/*
+ * Function: parse_rules
+ * ---------------------
+ * Parses every non-empty line of a rules file with parse_class_line.
+ *
+ * Parameters:
+ *   - text     : whole contents of the rules file.
+ *   - classes  : receives the successfully parsed classes, in line order.
+ *   - errors   : receives the parsing errors with their line numbers.
+ *   - rejected : receives the rejected lines with their position, in line order.
+ */
+void parse_rules(std::string_view text, std::vector<ClassRule>& classes, ErrorSink& errors,
+    std::vector<RuleDiagnostic>& rejected);
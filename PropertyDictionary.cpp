@@ -0,0 +1,146 @@
+/*
+ * File: PropertyDictionary.cpp
+ * ----------------------------
+ * Implements the process-wide property name dictionary.
+ */
+
+#include "PropertyDictionary.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+    // ASCII case folding, as std::tolower does in the "C" locale
+    inline char fold(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    // FNV-1a over the folded characters
+    struct FoldedHash {
+        size_t operator()(std::string_view s) const {
+            uint64_t h = 14695981039346656037ULL;
+            for (char c : s) {
+                h ^= static_cast<unsigned char>(fold(c));
+                h *= 1099511628211ULL;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    struct FoldedEqual {
+        bool operator()(std::string_view a, std::string_view b) const {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); i++)
+                if (fold(a[i]) != fold(b[i])) return false;
+            return true;
+        }
+    };
+
+    /*
+     * Structure: Dictionary
+     * ---------------------
+     * Names by id and ids by name. The deque never moves its strings, so
+     * the map keys and the views returned by property_name stay valid.
+     * Lookups, the common case, only take the lock shared.
+     */
+    struct Dictionary {
+        std::shared_mutex mutex;
+        std::deque<std::string> names;
+        std::unordered_map<std::string_view, PropertyId, FoldedHash, FoldedEqual> ids;
+    };
+
+    Dictionary& dictionary() {
+        static Dictionary d;
+        return d;
+    }
+
+    // Per-thread copy of the ids this thread has interned. Ids never
+    // change and the keys view the dictionary's own strings, so a hit
+    // needs neither the lock nor an allocation.
+    using LocalIds = std::unordered_map<std::string_view, PropertyId, FoldedHash, FoldedEqual>;
+
+    LocalIds& local_ids() {
+        thread_local LocalIds ids;
+        return ids;
+    }
+}
+
+/*
+ * Function: intern_property
+ * -------------------------
+ * Answers from the calling thread's cache when it can, so parser threads
+ * interning the same few names over and over take no lock. A miss looks
+ * the name up under a shared lock; only a new name takes the lock
+ * exclusively (and is looked up again, another thread may have added it).
+ */
+PropertyId intern_property(std::string_view name) {
+    LocalIds& local = local_ids();
+    auto hit = local.find(name);
+    if (hit != local.end()) return hit->second;
+
+    Dictionary& d = dictionary();
+    std::pair<std::string_view, PropertyId> entry;
+    bool known = false;
+    {
+        std::shared_lock<std::shared_mutex> lock(d.mutex);
+        auto it = d.ids.find(name);
+        if (it != d.ids.end()) {
+            entry = *it;
+            known = true;
+        }
+    }
+
+    if (!known) {
+        std::unique_lock<std::shared_mutex> lock(d.mutex);
+        auto it = d.ids.find(name);
+        if (it == d.ids.end()) {
+            std::string folded(name);
+            for (char& c : folded) c = fold(c);
+            PropertyId id = static_cast<PropertyId>(d.names.size());
+            d.names.push_back(std::move(folded));
+            it = d.ids.emplace(d.names.back(), id).first;
+        }
+        entry = *it;
+    }
+
+    local.insert(entry);
+    return entry.second;
+}
+
+/*
+ * Function: find_property
+ * -----------------------
+ * Looks the name up without adding it.
+ */
+PropertyId find_property(std::string_view name) {
+    Dictionary& d = dictionary();
+    std::shared_lock<std::shared_mutex> lock(d.mutex);
+    auto it = d.ids.find(name);
+    return it == d.ids.end() ? NO_PROPERTY : it->second;
+}
+
+/*
+ * Function: property_name
+ * -----------------------
+ * Returns the interned (lowercase) name of an id.
+ */
+std::string_view property_name(PropertyId id) {
+    Dictionary& d = dictionary();
+    std::shared_lock<std::shared_mutex> lock(d.mutex);
+    return id < d.names.size() ? std::string_view(d.names[id]) : std::string_view();
+}
+
+/*
+ * Function: property_count
+ * ------------------------
+ * Returns the number of interned names.
+ */
+size_t property_count() {
+    Dictionary& d = dictionary();
+    std::shared_lock<std::shared_mutex> lock(d.mutex);
+    return d.names.size();
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+/*
+ * File: PropertyDictionary.h
+ * --------------------------
+ * Process-wide dictionary of property names.
+ *
+ * Every property name met in records or rules is interned once, folded to
+ * lowercase, and identified from then on by a dense integer id. Records
+ * and rules store ids instead of names, so matching compares integers and
+ * "Color" in a rule finds "color" in a record. Ids are assigned in order
+ * of first use, stay valid for the lifetime of the process and are not
+ * stable across runs (binary files store names, not ids).
+ *
+ * All functions are thread-safe; records parsed on several threads share
+ * one dictionary. Each thread also caches the ids it has interned, so
+ * repeated names are resolved without locking.
+ */
+
+// Dense id of an interned property name
+using PropertyId = uint32_t;
+
+// Id that no interned name has (unknown property)
+const PropertyId NO_PROPERTY = UINT32_MAX;
+
+/*
+ * Function: intern_property
+ * -------------------------
+ * Returns the id of a property name, adding the name if it is new. Names
+ * differing only in ASCII letter case get the same id.
+ */
+PropertyId intern_property(std::string_view name);
+
+/*
+ * Function: find_property
+ * -----------------------
+ * Returns the id of a property name (case-insensitive), or NO_PROPERTY if
+ * no record or rule has used it. Never adds names.
+ */
+PropertyId find_property(std::string_view name);
+
+/*
+ * Function: property_name
+ * -----------------------
+ * Returns the lowercase name of an id ("" for NO_PROPERTY). The view stays
+ * valid for the lifetime of the process.
+ */
+std::string_view property_name(PropertyId id);
+
+/*
+ * Function: property_count
+ * ------------------------
+ * Returns the number of interned names; ids are below this value.
+ */
+size_t property_count();
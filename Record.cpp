@@ -5,20 +5,73 @@
  */
 
 #include "Record.h"
+#include <algorithm>
+
+/*
+ * Constructor: Record
+ * -------------------
+ * Builds a record from (id, values) pairs. A repeated id keeps its first
+ * values, as inserting into a map would.
+ */
+Record::Record(std::string_view name, std::initializer_list<std::pair<PropertyId, Property>> props)
+    : name(name) {
+    for (const auto& p : props)
+        addProperty(p.first, p.second.values.data(), p.second.values.size());
+}
+
+/*
+ * Function: entry_before
+ * ----------------------
+ * Orders property entries by id, for binary searches.
+ */
+static bool entry_before(const PropertyEntry& entry, PropertyId id) {
+    return entry.id < id;
+}
 
  /*
   * Method: getProperty
   * -------------------
-  * Retrieves a property from the record by its name.
+  * Retrieves a property from the record by the id of its name.
   *
   * Parameters:
-  *   - propName : the name of the property to look for.
+  *   - id : the interned property name to look for.
   *
   * Returns:
-  *   - pointer to the Property if found,
+  *   - pointer to the entry of the property if found,
   *   - nullptr if the property does not exist.
   */
-const Property* Record::getProperty(const std::string& propName) const {
-    auto it = properties.find(propName);
-    return (it == properties.end()) ? nullptr : &it->second;
+const PropertyEntry* Record::getProperty(PropertyId id) const {
+    auto it = std::lower_bound(properties.begin(), properties.end(), id, entry_before);
+    return (it == properties.end() || it->id != id) ? nullptr : &*it;
+}
+
+/*
+ * Method: getProperty
+ * -------------------
+ * Retrieves a property from the record by its name (case-insensitive).
+ * A name that was never interned belongs to no record.
+ */
+const PropertyEntry* Record::getProperty(std::string_view propName) const {
+    PropertyId id = find_property(propName);
+    return id == NO_PROPERTY ? nullptr : getProperty(id);
+}
+
+/*
+ * Method: addProperty
+ * -------------------
+ * Appends the values to the value buffer and inserts the entry at its
+ * sorted position.
+ *
+ * Returns:
+ *   - true  if the property was added,
+ *   - false if the record already has a property with this id.
+ */
+bool Record::addProperty(PropertyId id, const int* first, size_t count) {
+    auto it = std::lower_bound(properties.begin(), properties.end(), id, entry_before);
+    if (it != properties.end() && it->id == id)
+        return false;
+
+    properties.insert(it, { id, static_cast<uint32_t>(values.size()), static_cast<uint32_t>(count) });
+    values.insert(values.end(), first, first + count);
+    return true;
 }
@@ -1,21 +1,57 @@
 ﻿#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
-#include <map>
+#include "PropertyDictionary.h"
+#include "SmallVector.h"
 
 /*
  * Structure: Property
  * -------------------
- * Represents a single property of a record.
+ * Values of a single property, used to build a record by hand.
  * Example: "color = [1, 2]"
  *
+ * Records do not store Property objects: their values are copied into
+ * the record's value buffer, and the property is keyed by the id of its
+ * interned name (see PropertyDictionary.h).
+ *
  * Fields:
- *   - name: the name of the property (e.g., "color", "size").
  *   - values: a list of integer values associated with this property.
  */
 struct Property {
-    std::string name;              // Property name
-    std::vector<int> values;       // List of integer values
+    IntList values;                // List of integer values
+};
+
+/*
+ * Structure: PropertyEntry
+ * ------------------------
+ * One property of a record: its name id and where its values lie in the
+ * record's value buffer.
+ */
+struct PropertyEntry {
+    PropertyId id;                 // Interned property name
+    uint32_t offset;               // First value in Record::values
+    uint32_t length;               // Number of values
+};
+
+/*
+ * Structure: PropertyValues
+ * -------------------------
+ * Read-only view of the values of one property.
+ */
+struct PropertyValues {
+    const int* data = nullptr;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const int* begin() const { return data; }
+    const int* end() const { return data + count; }
+    int operator[](size_t i) const { return data[i]; }
 };
 
 /*
@@ -27,18 +63,49 @@ struct Property {
  * Example:
  *   Wardrobe: color = [1, 2], size = [10, 40, 60]
  *
+ * The record is flat: the properties are an array of entries sorted by
+ * property id, and the values of all properties share one contiguous
+ * buffer. A record costs at most three allocations (name, entries,
+ * values) however many properties it has, and a lookup is a binary
+ * search over a few cache lines.
+ *
+ * The three buffers use a polymorphic allocator: records parsed from a
+ * file are allocated from a RecordArena (see RecordArena.h), other
+ * records from the default resource. Moving keeps the allocator,
+ * copying uses the default resource.
+ *
  * Fields:
  *   - name: the unique name of the record.
- *   - properties: a map where each key is the property name
- *                 and the value is a Property structure.
+ *   - properties: the property entries, sorted by id, ids unique.
+ *   - values: the values of all properties (in insertion order).
  *
  * Methods:
- *   - getProperty: retrieves a property by name. Returns nullptr if not found.
+ *   - getProperty: retrieves a property by id or by name (case-insensitive).
+ *                  Returns nullptr if not found.
+ *   - valuesOf:    returns the values of a property entry.
+ *   - addProperty: adds a property unless the record already has it.
  */
 struct Record {
-    std::string name;                                // Record name (e.g., "Wardrobe")
-    std::map<std::string, Property> properties;      // Map of property name → Property
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    std::pmr::string name;                           // Record name (e.g., "Wardrobe")
+    std::pmr::vector<PropertyEntry> properties;      // Sorted by property id
+    std::pmr::vector<int> values;                    // Values of all properties
+
+    Record() = default;
+    explicit Record(const allocator_type& alloc)
+        : name(alloc), properties(alloc), values(alloc) {}
+    Record(std::string_view name, std::initializer_list<std::pair<PropertyId, Property>> props);
+
+    // Retrieve a property by its id or name (returns nullptr if not found)
+    const PropertyEntry* getProperty(PropertyId id) const;
+    const PropertyEntry* getProperty(std::string_view propName) const;
+
+    // Values of one of this record's properties
+    PropertyValues valuesOf(const PropertyEntry& entry) const {
+        return { values.data() + entry.offset, entry.length };
+    }
 
-    // Retrieve a property by its name (returns nullptr if not found)
-    const Property* getProperty(const std::string& propName) const;
+    // Add a property (returns false if the record already has it)
+    bool addProperty(PropertyId id, const int* first, size_t count);
 };
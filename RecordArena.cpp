@@ -0,0 +1,26 @@
+/*
+ * File: RecordArena.cpp
+ * ---------------------
+ * Implements the per-chunk record arena.
+ */
+
+#include "RecordArena.h"
+#include <algorithm>
+
+// Smallest first block of a chunk resource
+static const size_t MIN_ARENA_BLOCK = 64 * 1024;
+
+/*
+ * Method: prepare
+ * ---------------
+ * Parsed records take about as many bytes as the text they come from
+ * (a value is 4 bytes, its text "12, " as many), so a first block the
+ * size of the chunk text holds most chunks whole. Resources of a
+ * previous parse are released first.
+ */
+void RecordArena::prepare(size_t count, size_t bytesPerChunk) {
+    resources_.clear();
+    size_t block = std::max(MIN_ARENA_BLOCK, bytesPerChunk);
+    for (size_t i = 0; i < count; i++)
+        resources_.push_back(std::make_unique<std::pmr::monotonic_buffer_resource>(block));
+}
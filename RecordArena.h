@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/*
+ * File: RecordArena.h
+ * -------------------
+ * Arena memory for the records of one parse.
+ */
+
+/*
+ * Class: RecordArena
+ * ------------------
+ * Monotonic memory for the names, property entries and values of the
+ * records of an items file. Deallocation is a no-op; everything is
+ * released at once, in a few large blocks, when the arena is released
+ * or destroyed, instead of block by block as records die.
+ *
+ * Chunks of the file are parsed on different threads and a monotonic
+ * resource is not thread-safe, so the arena holds one resource per
+ * chunk. prepare() must create them before the workers start.
+ *
+ * Records allocated from an arena keep it when moved; copies use the
+ * default resource. All records using an arena must be destroyed (or
+ * cleared) before the arena is released.
+ *
+ * Example:
+ *   RecordArena arena;
+ *   std::vector<Record> records;
+ *   parse_records(text, records, errors, rejected, threads, &arena);
+ */
+class RecordArena {
+public:
+    RecordArena() = default;
+    RecordArena(const RecordArena&) = delete;
+    RecordArena& operator=(const RecordArena&) = delete;
+
+    // Creates the resources of count chunks; the first block of each is
+    // sized for about bytesPerChunk bytes of input text
+    void prepare(size_t count, size_t bytesPerChunk);
+
+    // Resource of chunk i (i < chunks())
+    std::pmr::memory_resource* chunk(size_t i) { return resources_[i].get(); }
+    size_t chunks() const { return resources_.size(); }
+
+    // Returns all memory to the system
+    void release() { resources_.clear(); }
+
+private:
+    std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> resources_;
+};
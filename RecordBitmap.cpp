@@ -0,0 +1,227 @@
+/*
+ * File: RecordBitmap.cpp
+ * ----------------------
+ * Containers and intersection of the compressed record bitmap.
+ */
+
+#include "RecordBitmap.h"
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Words of a dense container
+static const size_t BITSET_WORDS = 65536 / 64;
+
+/*
+ * Function: popcount
+ * ------------------
+ * Number of set bits of a word.
+ */
+static inline unsigned popcount(uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return (unsigned)__popcnt64(word);
+#elif defined(_MSC_VER)
+    return (unsigned)(__popcnt((unsigned)word) + __popcnt((unsigned)(word >> 32)));
+#else
+    return (unsigned)__builtin_popcountll(word);
+#endif
+}
+
+/*
+ * Method: lowest_bit
+ * ------------------
+ * Index of the lowest set bit of a non-zero word.
+ */
+unsigned RecordBitmap::lowest_bit(uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, word);
+    return (unsigned)idx;
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    if (_BitScanForward(&idx, (unsigned long)word)) return (unsigned)idx;
+    _BitScanForward(&idx, (unsigned long)(word >> 32));
+    return (unsigned)idx + 32;
+#else
+    return (unsigned)__builtin_ctzll(word);
+#endif
+}
+
+/*
+ * Method: fromSorted
+ * ------------------
+ * Adds the ids one by one; containers switch to a bitset as they fill.
+ */
+RecordBitmap RecordBitmap::fromSorted(const uint32_t* ids, size_t count) {
+    RecordBitmap bitmap;
+    for (size_t i = 0; i < count; i++)
+        bitmap.add(ids[i]);
+    return bitmap;
+}
+
+/*
+ * Method: range
+ * -------------
+ * Full containers are written as bitsets directly.
+ */
+RecordBitmap RecordBitmap::range(uint32_t count) {
+    RecordBitmap bitmap;
+    for (uint32_t first = 0; first < count; first += 65536) {
+        uint32_t n = std::min<uint32_t>(65536, count - first);
+        Container c;
+        c.key = static_cast<uint16_t>(first >> 16);
+        c.cardinality = n;
+        if (n <= ARRAY_MAX) {
+            for (uint32_t i = 0; i < n; i++) c.array.push_back(static_cast<uint16_t>(i));
+        }
+        else {
+            c.bits.assign(BITSET_WORDS, 0);
+            for (uint32_t w = 0; w < n / 64; w++) c.bits[w] = ~uint64_t(0);
+            if (n % 64) c.bits[n / 64] = (uint64_t(1) << (n % 64)) - 1;
+        }
+        bitmap.containers_.push_back(std::move(c));
+    }
+    return bitmap;
+}
+
+/*
+ * Method: add
+ * -----------
+ * Appends to the last container, or opens a new one.
+ */
+void RecordBitmap::add(uint32_t id) {
+    const uint16_t key = static_cast<uint16_t>(id >> 16), low = static_cast<uint16_t>(id);
+    if (containers_.empty() || containers_.back().key != key) {
+        containers_.emplace_back();
+        containers_.back().key = key;
+    }
+    Container& c = containers_.back();
+    if (c.bits.empty()) {
+        c.array.push_back(low);
+        if (c.array.size() > ARRAY_MAX) toBitset(c);
+    }
+    else {
+        c.bits[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+    c.cardinality++;
+}
+
+/*
+ * Method: cardinality
+ * -------------------
+ * Sum of the container sizes.
+ */
+size_t RecordBitmap::cardinality() const {
+    size_t n = 0;
+    for (const auto& c : containers_) n += c.cardinality;
+    return n;
+}
+
+/*
+ * Method: contains
+ * ----------------
+ * Binary search for the container, then for the low bits.
+ */
+bool RecordBitmap::contains(uint32_t id) const {
+    const uint16_t key = static_cast<uint16_t>(id >> 16), low = static_cast<uint16_t>(id);
+    auto it = std::lower_bound(containers_.begin(), containers_.end(), key,
+        [](const Container& c, uint16_t k) { return c.key < k; });
+    if (it == containers_.end() || it->key != key) return false;
+    if (it->bits.empty())
+        return std::binary_search(it->array.begin(), it->array.end(), low);
+    return (it->bits[low >> 6] >> (low & 63)) & 1;
+}
+
+/*
+ * Method: toBitset
+ * ----------------
+ * Converts an array container into a bitset container.
+ */
+void RecordBitmap::toBitset(Container& c) {
+    c.bits.assign(BITSET_WORDS, 0);
+    for (uint16_t low : c.array)
+        c.bits[low >> 6] |= uint64_t(1) << (low & 63);
+    std::vector<uint16_t>().swap(c.array);
+}
+
+/*
+ * Method: toArray
+ * ---------------
+ * Converts a bitset container into an array container.
+ */
+void RecordBitmap::toArray(Container& c) {
+    c.array.clear();
+    c.array.reserve(c.cardinality);
+    for (size_t w = 0; w < c.bits.size(); w++)
+        for (uint64_t word = c.bits[w]; word != 0; word &= word - 1)
+            c.array.push_back(static_cast<uint16_t>(w * 64 + lowest_bit(word)));
+    std::vector<uint64_t>().swap(c.bits);
+}
+
+/*
+ * Method: intersect
+ * -----------------
+ * Intersects container a with b in place; false if a became empty.
+ * Array with array is a merge, array with bitset a filter, and bitset
+ * with bitset a word-wise AND, converted back to an array when sparse.
+ */
+bool RecordBitmap::intersect(Container& a, const Container& b) {
+    if (a.bits.empty()) {
+        size_t kept = 0;
+        if (b.bits.empty()) {
+            size_t j = 0;
+            for (uint16_t low : a.array) {
+                while (j < b.array.size() && b.array[j] < low) j++;
+                if (j == b.array.size()) break;
+                if (b.array[j] == low) a.array[kept++] = low;
+            }
+        }
+        else {
+            for (uint16_t low : a.array)
+                if ((b.bits[low >> 6] >> (low & 63)) & 1) a.array[kept++] = low;
+        }
+        a.array.resize(kept);
+        a.cardinality = static_cast<uint32_t>(kept);
+    }
+    else if (b.bits.empty()) {
+        Container result;
+        result.key = a.key;
+        for (uint16_t low : b.array)
+            if ((a.bits[low >> 6] >> (low & 63)) & 1) result.array.push_back(low);
+        result.cardinality = static_cast<uint32_t>(result.array.size());
+        a = std::move(result);
+    }
+    else {
+        uint32_t n = 0;
+        for (size_t w = 0; w < BITSET_WORDS; w++) {
+            a.bits[w] &= b.bits[w];
+            n += popcount(a.bits[w]);
+        }
+        a.cardinality = n;
+        if (n <= ARRAY_MAX) toArray(a);
+    }
+    return a.cardinality > 0;
+}
+
+/*
+ * Method: operator&=
+ * ------------------
+ * Merges the sorted container lists; containers without a partner or
+ * left empty are dropped.
+ */
+RecordBitmap& RecordBitmap::operator&=(const RecordBitmap& other) {
+    size_t kept = 0, j = 0;
+    for (size_t i = 0; i < containers_.size(); i++) {
+        while (j < other.containers_.size() && other.containers_[j].key < containers_[i].key) j++;
+        if (j == other.containers_.size()) break;
+        if (other.containers_[j].key != containers_[i].key) continue;
+        if (intersect(containers_[i], other.containers_[j])) {
+            if (kept != i) containers_[kept] = std::move(containers_[i]);
+            kept++;
+        }
+    }
+    containers_.resize(kept);
+    return *this;
+}
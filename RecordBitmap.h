@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * File: RecordBitmap.h
+ * --------------------
+ * Compressed set of record ids.
+ */
+
+/*
+ * Class: RecordBitmap
+ * -------------------
+ * Set of record ids in the style of a roaring bitmap: ids are split by
+ * their high 16 bits into containers of up to 65536 ids, and each
+ * container stores its low 16 bits either as a sorted array (sparse,
+ * up to ARRAY_MAX ids, 2 bytes per id) or as a 65536-bit bitset (dense,
+ * 8 KiB). Intersections work container by container, with word-wide
+ * ANDs between dense containers.
+ *
+ * Ids must be added in ascending order.
+ *
+ * Example:
+ *   RecordBitmap a, b;
+ *   a.add(1); a.add(70000);
+ *   b.add(70000);
+ *   a &= b;
+ *   a.forEach([](uint32_t id) { ... });   // 70000
+ */
+class RecordBitmap {
+public:
+    // Largest number of ids an array container holds
+    static const uint32_t ARRAY_MAX = 4096;
+
+    RecordBitmap() = default;
+
+    // Bitmap of a sorted list of distinct ids
+    static RecordBitmap fromSorted(const uint32_t* ids, size_t count);
+
+    // Bitmap of the ids [0, count)
+    static RecordBitmap range(uint32_t count);
+
+    // Adds an id greater than all ids added before
+    void add(uint32_t id);
+
+    // Number of ids
+    size_t cardinality() const;
+    bool empty() const { return containers_.empty(); }
+
+    bool contains(uint32_t id) const;
+
+    // Keeps only the ids that are also in other
+    RecordBitmap& operator&=(const RecordBitmap& other);
+
+    // Calls f(id) for every id, in ascending order
+    template <class F>
+    void forEach(F f) const {
+        for (const auto& c : containers_) {
+            const uint32_t high = uint32_t(c.key) << 16;
+            if (c.bits.empty()) {
+                for (uint16_t low : c.array) f(high | low);
+            }
+            else {
+                for (size_t w = 0; w < c.bits.size(); w++)
+                    for (uint64_t word = c.bits[w]; word != 0; word &= word - 1)
+                        f(high | uint32_t(w * 64 + lowest_bit(word)));
+            }
+        }
+    }
+
+private:
+    // Ids sharing their high 16 bits; one of array/bits is used
+    struct Container {
+        uint16_t key = 0;
+        uint32_t cardinality = 0;
+        std::vector<uint16_t> array;   // Sparse: sorted low bits
+        std::vector<uint64_t> bits;    // Dense: 1024 words
+    };
+
+    static unsigned lowest_bit(uint64_t word);
+    static void toBitset(Container& c);
+    static void toArray(Container& c);
+    static bool intersect(Container& a, const Container& b);
+
+    std::vector<Container> containers_;  // Sorted by key
+};
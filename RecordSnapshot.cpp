@@ -0,0 +1,288 @@
+/*
+ * File: RecordSnapshot.cpp
+ * ------------------------
+ * Writes and loads binary columnar snapshots of parsed records.
+ */
+
+#include "RecordSnapshot.h"
+#include "BinaryFormat.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+static const char SNAPSHOT_MAGIC[8] = { 'F', 'R', 'I', 'T', 'E', 'M', 'S', '\0' };
+
+/*
+ * Function: is_record_snapshot
+ * ----------------------------
+ * Compares the first bytes of data with the snapshot magic.
+ */
+bool is_record_snapshot(std::string_view data) {
+    return data.size() >= sizeof(SNAPSHOT_MAGIC) &&
+        std::memcmp(data.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0;
+}
+
+/*
+ * Function: write_record_snapshot
+ * -------------------------------
+ * Interns the property names of all records, lays the records out in
+ * columns and writes header and sections in file order.
+ */
+bool write_record_snapshot(std::ostream& out, const std::vector<Record>& records) {
+    // Step 1: Intern property names (sorted, so ids follow name order)
+    std::vector<std::string_view> names;
+    for (const auto& rec : records)
+        for (const auto& entry : rec.properties)
+            names.push_back(property_name(entry.id));
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    std::vector<uint64_t> propertyNameOffsets{ 0 };
+    std::string propertyNames;
+    for (std::string_view n : names) {
+        propertyNames.append(n);
+        propertyNameOffsets.push_back(propertyNames.size());
+    }
+
+    // Step 2: Build the record columns. Records order their properties by
+    // dictionary id, so the snapshot ids of each record are sorted here.
+    std::vector<uint64_t> recordNameOffsets{ 0 }, recordProperties{ 0 }, valueOffsets{ 0 };
+    std::vector<int32_t> values;
+    std::vector<uint32_t> propertyIds;
+    std::string recordNames;
+    std::vector<std::pair<uint32_t, PropertyValues>> sorted;
+    for (const auto& rec : records) {
+        recordNames.append(rec.name);
+        recordNameOffsets.push_back(recordNames.size());
+
+        sorted.clear();
+        for (const auto& entry : rec.properties) {
+            auto id = std::lower_bound(names.begin(), names.end(), property_name(entry.id));
+            sorted.emplace_back(static_cast<uint32_t>(id - names.begin()), rec.valuesOf(entry));
+        }
+        std::sort(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        for (const auto& entry : sorted) {
+            propertyIds.push_back(entry.first);
+            values.insert(values.end(), entry.second.begin(), entry.second.end());
+            valueOffsets.push_back(values.size());
+        }
+        recordProperties.push_back(propertyIds.size());
+    }
+
+    // Step 3: Fill in the header
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = RECORD_SNAPSHOT_VERSION;
+    header.byteOrder = BINARY_BYTE_ORDER;
+    header.recordCount = records.size();
+    header.nameCount = names.size();
+    header.propertyCount = propertyIds.size();
+    header.valueCount = values.size();
+    header.recordNameBytes = recordNames.size();
+    header.propertyNameBytes = propertyNames.size();
+    header.fileSize = sizeof(SnapshotHeader)
+        + padded(recordNameOffsets.size() * sizeof(uint64_t))
+        + padded(recordProperties.size() * sizeof(uint64_t))
+        + padded(propertyNameOffsets.size() * sizeof(uint64_t))
+        + padded(valueOffsets.size() * sizeof(uint64_t))
+        + padded(values.size() * sizeof(int32_t))
+        + padded(propertyIds.size() * sizeof(uint32_t))
+        + padded(recordNames.size())
+        + padded(propertyNames.size());
+
+    // Step 4: Write header and sections
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_section(out, recordNameOffsets.data(), recordNameOffsets.size() * sizeof(uint64_t));
+    write_section(out, recordProperties.data(), recordProperties.size() * sizeof(uint64_t));
+    write_section(out, propertyNameOffsets.data(), propertyNameOffsets.size() * sizeof(uint64_t));
+    write_section(out, valueOffsets.data(), valueOffsets.size() * sizeof(uint64_t));
+    write_section(out, values.data(), values.size() * sizeof(int32_t));
+    write_section(out, propertyIds.data(), propertyIds.size() * sizeof(uint32_t));
+    write_section(out, recordNames.data(), recordNames.size());
+    write_section(out, propertyNames.data(), propertyNames.size());
+    return !out.fail();
+}
+
+/*
+ * Function: write_record_snapshot
+ * -------------------------------
+ * Writes a snapshot file at path.
+ */
+bool write_record_snapshot(const std::string& path, const std::vector<Record>& records) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !write_record_snapshot(out, records)) return false;
+
+    out.close();
+    return !out.fail();
+}
+
+/*
+ * Method: load
+ * ------------
+ * Validates the header against the buffer size, sets up the column
+ * pointers and checks the offset and id columns so that later lookups
+ * never read outside the buffer.
+ *
+ * Returns:
+ *   true  if data holds a complete snapshot of the current version,
+ *   false otherwise (see error()).
+ */
+bool RecordSnapshot::load(std::string_view data) {
+    *this = RecordSnapshot();
+
+    // Step 1: Header
+    SnapshotHeader h;
+    if (!is_record_snapshot(data) || data.size() < sizeof(h)) {
+        error_ = "not a record snapshot";
+        return false;
+    }
+    std::memcpy(&h, data.data(), sizeof(h));
+    if (h.version != RECORD_SNAPSHOT_VERSION || h.byteOrder != BINARY_BYTE_ORDER) {
+        error_ = "unsupported snapshot version or byte order";
+        return false;
+    }
+    if (reinterpret_cast<uintptr_t>(data.data()) % 8 != 0) {
+        error_ = "snapshot buffer is not aligned";
+        return false;
+    }
+
+    // Step 2: Section sizes must add up to the file size. Every count is
+    // bounded by the file size first so that the sum cannot overflow.
+    const uint64_t size = data.size();
+    if (h.fileSize != size || h.recordCount >= size / 8 || h.nameCount >= size / 8 ||
+        h.propertyCount >= size / 8 || h.valueCount > size / 4 ||
+        h.recordNameBytes > size || h.propertyNameBytes > size) {
+        error_ = "snapshot is truncated or corrupt";
+        return false;
+    }
+    uint64_t expected = sizeof(SnapshotHeader)
+        + 2 * padded((h.recordCount + 1) * sizeof(uint64_t))
+        + padded((h.nameCount + 1) * sizeof(uint64_t))
+        + padded((h.propertyCount + 1) * sizeof(uint64_t))
+        + padded(h.valueCount * sizeof(int32_t))
+        + padded(h.propertyCount * sizeof(uint32_t))
+        + padded(h.recordNameBytes)
+        + padded(h.propertyNameBytes);
+    if (expected != size) {
+        error_ = "snapshot is truncated or corrupt";
+        return false;
+    }
+
+    // Step 3: Column pointers, in file order
+    const char* p = data.data() + sizeof(SnapshotHeader);
+    auto take = [&p](uint64_t bytes) { const char* s = p; p += padded(bytes); return s; };
+    recordNameOffsets_ = reinterpret_cast<const uint64_t*>(take((h.recordCount + 1) * sizeof(uint64_t)));
+    recordProperties_ = reinterpret_cast<const uint64_t*>(take((h.recordCount + 1) * sizeof(uint64_t)));
+    propertyNameOffsets_ = reinterpret_cast<const uint64_t*>(take((h.nameCount + 1) * sizeof(uint64_t)));
+    valueOffsets_ = reinterpret_cast<const uint64_t*>(take((h.propertyCount + 1) * sizeof(uint64_t)));
+    values_ = reinterpret_cast<const int32_t*>(take(h.valueCount * sizeof(int32_t)));
+    propertyIds_ = reinterpret_cast<const uint32_t*>(take(h.propertyCount * sizeof(uint32_t)));
+    recordNames_ = take(h.recordNameBytes);
+    propertyNames_ = take(h.propertyNameBytes);
+    recordCount_ = static_cast<size_t>(h.recordCount);
+    nameCount_ = static_cast<size_t>(h.nameCount);
+
+    // Step 4: Offsets stay inside their sections; ids are known and
+    // strictly increasing within each record
+    bool valid = offsets_valid(recordNameOffsets_, h.recordCount, h.recordNameBytes) &&
+        offsets_valid(recordProperties_, h.recordCount, h.propertyCount) &&
+        offsets_valid(propertyNameOffsets_, h.nameCount, h.propertyNameBytes) &&
+        offsets_valid(valueOffsets_, h.propertyCount, h.valueCount);
+    for (size_t r = 0; valid && r < recordCount_; r++) {
+        for (uint64_t i = recordProperties_[r]; i < recordProperties_[r + 1]; i++) {
+            if (propertyIds_[i] >= h.nameCount ||
+                (i > recordProperties_[r] && propertyIds_[i] <= propertyIds_[i - 1])) {
+                valid = false;
+                break;
+            }
+        }
+    }
+    if (!valid) {
+        *this = RecordSnapshot();
+        error_ = "snapshot is truncated or corrupt";
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Method: name
+ * ------------
+ * Returns the name of a record as a view into the snapshot.
+ */
+std::string_view RecordSnapshot::name(size_t record) const {
+    return { recordNames_ + recordNameOffsets_[record],
+        static_cast<size_t>(recordNameOffsets_[record + 1] - recordNameOffsets_[record]) };
+}
+
+/*
+ * Method: propertyName
+ * --------------------
+ * Returns an interned property name by id.
+ */
+std::string_view RecordSnapshot::propertyName(size_t nameId) const {
+    return { propertyNames_ + propertyNameOffsets_[nameId],
+        static_cast<size_t>(propertyNameOffsets_[nameId + 1] - propertyNameOffsets_[nameId]) };
+}
+
+/*
+ * Method: findName
+ * ----------------
+ * Binary search over the sorted name table.
+ */
+int RecordSnapshot::findName(std::string_view propertyName) const {
+    size_t lo = 0, hi = nameCount_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (this->propertyName(mid) < propertyName) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < nameCount_ && this->propertyName(lo) == propertyName)
+        return static_cast<int>(lo);
+    return -1;
+}
+
+/*
+ * Method: findProperty
+ * --------------------
+ * Binary search over the sorted ids of one record.
+ *
+ * Returns:
+ *   true  with values/count set if the record has the property,
+ *   false otherwise.
+ */
+bool RecordSnapshot::findProperty(size_t record, int nameId, const int*& values, size_t& count) const {
+    if (nameId < 0) return false;
+
+    const uint32_t* first = propertyIds_ + recordProperties_[record];
+    const uint32_t* last = propertyIds_ + recordProperties_[record + 1];
+    const uint32_t* it = std::lower_bound(first, last, static_cast<uint32_t>(nameId));
+    if (it == last || *it != static_cast<uint32_t>(nameId))
+        return false;
+
+    size_t i = static_cast<size_t>(it - propertyIds_);
+    values = values_ + valueOffsets_[i];
+    count = static_cast<size_t>(valueOffsets_[i + 1] - valueOffsets_[i]);
+    return true;
+}
+
+/*
+ * Method: toRecord
+ * ----------------
+ * Copies one record out of the snapshot.
+ */
+Record RecordSnapshot::toRecord(size_t record, const Record::allocator_type& alloc) const {
+    const uint64_t first = recordProperties_[record], last = recordProperties_[record + 1];
+    Record rec(alloc);
+    rec.name.assign(name(record));
+    rec.properties.reserve(static_cast<size_t>(last - first));
+    rec.values.reserve(static_cast<size_t>(valueOffsets_[last] - valueOffsets_[first]));
+    for (uint64_t i = first; i < last; i++) {
+        rec.addProperty(intern_property(propertyName(propertyIds_[i])), values_ + valueOffsets_[i],
+            static_cast<size_t>(valueOffsets_[i + 1] - valueOffsets_[i]));
+    }
+    return rec;
+}
@@ -0,0 +1,145 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Record.h"
+
+/*
+ * File: RecordSnapshot.h
+ * ----------------------
+ * Binary columnar snapshot of parsed records.
+ *
+ * A snapshot is written once from the records parsed out of items.txt
+ * (--compile-items) and can then be memory-mapped and classified
+ * directly, without parsing any text.
+ *
+ * Layout (native byte order, every section 8-byte aligned):
+ *
+ *   SnapshotHeader
+ *   uint64 recordNameOffsets  [recordCount + 1]   into recordNames
+ *   uint64 recordProperties   [recordCount + 1]   into the property columns
+ *   uint64 propertyNameOffsets[nameCount + 1]     into propertyNames
+ *   uint64 valueOffsets       [propertyCount + 1] into values
+ *   int32  values             [valueCount]
+ *   uint32 propertyIds        [propertyCount]     sorted within a record
+ *   char   recordNames        [recordNameBytes]
+ *   char   propertyNames      [propertyNameBytes] sorted, distinct
+ *
+ * Property names are interned: each distinct name is stored once and
+ * records refer to it by id (its index in the sorted name table).
+ */
+
+// Version of the snapshot layout; bumped on every incompatible change
+const uint32_t RECORD_SNAPSHOT_VERSION = 1;
+
+/*
+ * Structure: SnapshotHeader
+ * -------------------------
+ * Fixed-size header at the start of a snapshot file.
+ */
+struct SnapshotHeader {
+    char magic[8];               // "FRITEMS" followed by '\0'
+    uint32_t version;            // RECORD_SNAPSHOT_VERSION
+    uint32_t byteOrder;          // 0x01020304 in the writer's byte order
+    uint64_t recordCount;        // Number of records
+    uint64_t nameCount;          // Number of distinct property names
+    uint64_t propertyCount;      // Number of (record, property) pairs
+    uint64_t valueCount;         // Total number of values
+    uint64_t recordNameBytes;    // Size of the record name bytes
+    uint64_t propertyNameBytes;  // Size of the property name bytes
+    uint64_t fileSize;           // Size of the whole file
+};
+
+/*
+ * Function: is_record_snapshot
+ * ----------------------------
+ * True if data starts with the snapshot magic (any version).
+ */
+bool is_record_snapshot(std::string_view data);
+
+/*
+ * Function: write_record_snapshot
+ * -------------------------------
+ * Writes records into a snapshot file at path.
+ *
+ * Returns:
+ *   true  on success,
+ *   false if the file cannot be created or written.
+ */
+bool write_record_snapshot(const std::string& path, const std::vector<Record>& records);
+
+/*
+ * Function: write_record_snapshot
+ * -------------------------------
+ * Writes the snapshot to an open binary stream (used to embed a
+ * snapshot in other files). The stream position must be 8-byte aligned
+ * relative to the start of the file for the snapshot to be loadable.
+ */
+bool write_record_snapshot(std::ostream& out, const std::vector<Record>& records);
+
+/*
+ * Class: RecordSnapshot
+ * ---------------------
+ * Read-only view of snapshot bytes (typically an InputFile mapping,
+ * which must outlive the view). load() only checks the header and the
+ * offset columns; records are then read straight from the buffer.
+ *
+ * Example:
+ *   InputFile in;
+ *   RecordSnapshot snapshot;
+ *   if (in.open("items.snap") && snapshot.load(in.data())) {
+ *       int id = snapshot.findName("color");
+ *       ...
+ *   }
+ */
+class RecordSnapshot {
+public:
+    // Attaches to snapshot bytes; on failure error() tells why
+    bool load(std::string_view data);
+
+    // Reason of the last load() failure
+    const std::string& error() const { return error_; }
+
+    // Number of records
+    size_t size() const { return recordCount_; }
+
+    // Name of a record
+    std::string_view name(size_t record) const;
+
+    // Id of a property name, or -1 if no record has this property
+    int findName(std::string_view propertyName) const;
+
+    // Looks up the values of a record's property by name id
+    bool findProperty(size_t record, int nameId, const int*& values, size_t& count) const;
+
+    // Number of distinct property names, and a name by id
+    size_t nameCount() const { return nameCount_; }
+    std::string_view propertyName(size_t nameId) const;
+
+    // Calls visit(nameId, values) for every property of a record, in
+    // name id order
+    template <class Visit>
+    void forEachProperty(size_t record, Visit visit) const {
+        for (uint64_t i = recordProperties_[record]; i < recordProperties_[record + 1]; i++)
+            visit(static_cast<size_t>(propertyIds_[i]), PropertyValues{ values_ + valueOffsets_[i],
+                static_cast<size_t>(valueOffsets_[i + 1] - valueOffsets_[i]) });
+    }
+
+    // Copies one record out of the snapshot, into memory from alloc
+    Record toRecord(size_t record, const Record::allocator_type& alloc = {}) const;
+
+private:
+    size_t recordCount_ = 0;
+    size_t nameCount_ = 0;
+    const uint64_t* recordNameOffsets_ = nullptr;
+    const uint64_t* recordProperties_ = nullptr;
+    const uint64_t* propertyNameOffsets_ = nullptr;
+    const uint64_t* valueOffsets_ = nullptr;
+    const int32_t* values_ = nullptr;
+    const uint32_t* propertyIds_ = nullptr;
+    const char* recordNames_ = nullptr;
+    const char* propertyNames_ = nullptr;
+    std::string error_;
+};
@@ -0,0 +1,354 @@
+/*
+ * File: RecordStore.cpp
+ * ---------------------
+ * Builds the columnar record store.
+ */
+
+#include "RecordStore.h"
+#include "ValueSearch.h"
+#include "RecordSnapshot.h"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+/*
+ * Structure: RecordListSource, SnapshotSource
+ * -------------------------------------------
+ * The records RecordStore::build reads: their number, the name of each
+ * and its properties as (property id, values). A snapshot's names are
+ * interned once, not per record.
+ */
+struct RecordListSource {
+    const std::vector<Record>& records;
+
+    size_t size() const { return records.size(); }
+    std::string_view name(size_t r) const { return records[r].name; }
+
+    template <class Visit>
+    void forEachProperty(size_t r, Visit visit) const {
+        for (const auto& entry : records[r].properties)
+            visit(entry.id, records[r].valuesOf(entry));
+    }
+};
+
+struct SnapshotSource {
+    const RecordSnapshot& snapshot;
+    std::vector<PropertyId> ids;         // By snapshot name id
+
+    explicit SnapshotSource(const RecordSnapshot& snapshot) : snapshot(snapshot) {
+        for (size_t i = 0; i < snapshot.nameCount(); i++)
+            ids.push_back(intern_property(snapshot.propertyName(i)));
+    }
+
+    size_t size() const { return snapshot.size(); }
+    std::string_view name(size_t r) const { return snapshot.name(r); }
+
+    template <class Visit>
+    void forEachProperty(size_t r, Visit visit) const {
+        snapshot.forEachProperty(r, [&](size_t nameId, PropertyValues values) { visit(ids[nameId], values); });
+    }
+};
+
+/*
+ * Constructor: RecordStore
+ * ------------------------
+ * Builds the store from parsed records.
+ */
+RecordStore::RecordStore(const std::vector<Record>& records, ValueStorage storage) {
+    build(RecordListSource{ records }, storage);
+}
+
+/*
+ * Constructor: RecordStore
+ * ------------------------
+ * Builds the store straight from a loaded snapshot, without making
+ * Record objects.
+ */
+RecordStore::RecordStore(const RecordSnapshot& snapshot, ValueStorage storage) {
+    build(SnapshotSource(snapshot), storage);
+}
+
+/*
+ * Method: build
+ * -------------
+ * Two passes over the records: the first lays out the names, creates a
+ * column for every property that occurs and counts the values of each
+ * record per column; after a prefix sum turns the counts into offsets,
+ * the second pass copies the values into place. Finally each column
+ * gets its specialized layout.
+ *
+ * Packed columns count per block of 64 records and note their value
+ * range in the first pass, so both packed arrays can be sized before
+ * the second pass writes the values and offsets into them directly.
+ */
+template <class Source>
+void RecordStore::build(const Source& source, ValueStorage storage) {
+    const size_t n = source.size();
+    const size_t words = (n + 63) / 64;
+    const bool packed = storage == ValueStorage::PACKED;
+    std::vector<int> lo, hi;           // PACKED: value range of each column
+
+    // Step 1: Names, presence bits and value counts
+    nameOffsets_.reserve(n + 1);
+    for (size_t r = 0; r < n; r++) {
+        names_.append(source.name(r));
+        nameOffsets_.push_back(names_.size());
+
+        source.forEachProperty(r, [&](PropertyId id, PropertyValues values) {
+            if (id >= columnIndex_.size())
+                columnIndex_.resize(id + 1, -1);
+            if (columnIndex_[id] < 0) {
+                columnIndex_[id] = static_cast<int32_t>(columns_.size());
+                columnIds_.push_back(id);
+                columns_.emplace_back();
+                columns_.back().records_ = n;
+                columns_.back().presence_.assign(words, 0);
+                if (packed)
+                    columns_.back().blockOffsets_.assign(words + 1, 0);
+                else
+                    columns_.back().offsets_.assign(n + 1, 0);
+                lo.push_back(std::numeric_limits<int>::max());
+                hi.push_back(std::numeric_limits<int>::min());
+            }
+            const size_t c = static_cast<size_t>(columnIndex_[id]);
+            PropertyColumn& column = columns_[c];
+            column.presence_[r >> 6] |= uint64_t(1) << (r & 63);
+            column.presentCount_++;
+            if (!packed) {
+                column.offsets_[r + 1] = values.count;
+                return;
+            }
+            column.blockOffsets_[(r >> 6) + 1] += values.count;
+            for (int v : values) {
+                lo[c] = std::min(lo[c], v);
+                hi[c] = std::max(hi[c], v);
+            }
+        });
+    }
+
+    // Step 2: Counts to offsets. A packed record's offset is stored as
+    // its distance from its block's, at most the largest block count.
+    for (size_t c = 0; c < columns_.size(); c++) {
+        PropertyColumn& column = columns_[c];
+        if (!packed) {
+            for (size_t r = 0; r < n; r++)
+                column.offsets_[r + 1] += column.offsets_[r];
+            column.values_.resize(static_cast<size_t>(column.offsets_[n]));
+            continue;
+        }
+
+        uint64_t widest = 0;
+        for (size_t b = 0; b < words; b++) {
+            widest = std::max(widest, column.blockOffsets_[b + 1]);
+            column.blockOffsets_[b + 1] += column.blockOffsets_[b];
+        }
+        column.layout_ = ValueLayout::PACKED;
+        column.packed_ = PackedInts(static_cast<size_t>(column.blockOffsets_[words]), lo[c], hi[c]);
+        if (widest <= static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            column.offsetDeltas_ = PackedInts(n + 1, 0, static_cast<int>(widest));
+        }
+        else {
+            column.offsets_.assign(n + 1, 0);
+            std::vector<uint64_t>().swap(column.blockOffsets_);
+        }
+    }
+
+    // Step 3: Copy the values (packed ones with the offsets of the
+    // records up to theirs, since the last record with the property)
+    std::vector<uint64_t> written(columns_.size(), 0);
+    std::vector<size_t> nextOffset(columns_.size(), 0);
+    for (size_t r = 0; r < n; r++) {
+        source.forEachProperty(r, [&](PropertyId id, PropertyValues values) {
+            const size_t c = static_cast<size_t>(columnIndex_[id]);
+            PropertyColumn& column = columns_[c];
+            if (!packed) {
+                std::copy(values.begin(), values.end(),
+                    column.values_.begin() + static_cast<ptrdiff_t>(column.offsets_[r]));
+                return;
+            }
+            column.fillOffsets(nextOffset[c], r + 1, written[c]);
+            nextOffset[c] = r + 1;
+            for (int v : values)
+                column.packed_.set(static_cast<size_t>(written[c]++), v);
+        });
+    }
+
+    // Step 4: Schema inference, or the offsets after the last record
+    // with the property
+    for (size_t c = 0; c < columns_.size(); c++) {
+        if (packed)
+            columns_[c].fillOffsets(nextOffset[c], n + 1, written[c]);
+        else
+            columns_[c].inferLayout();
+    }
+}
+
+/*
+ * Method: inferLayout
+ * -------------------
+ * Measures the column (whether all records with the property have
+ * exactly one value, value range) and picks the first
+ * layout that fits, in order of lookup cost: SCALAR, BITSET, SORTED.
+ * Columns with short lists over a wide range stay LISTS.
+ */
+void PropertyColumn::inferLayout() {
+    const size_t n = offsets_.size() - 1;
+    const size_t present = presentCount_;
+    bool single = true;
+    int lo = std::numeric_limits<int>::max(), hi = std::numeric_limits<int>::min();
+    for (size_t r = 0; r < n; r++)
+        if (has(r)) single = single && offsets_[r + 1] - offsets_[r] == 1;
+    for (int v : values_) {
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+    }
+
+    if (present > 0 && single) {
+        layout_ = ValueLayout::SCALAR;
+        scalars_.assign(n, 0);
+        for (size_t r = 0; r < n; r++)
+            if (has(r)) scalars_[r] = values_[offsets_[r]];
+    }
+    else if (!values_.empty() && static_cast<int64_t>(hi) - lo < 64) {
+        layout_ = ValueLayout::BITSET;
+        base_ = lo;
+        masks_.assign(n, 0);
+        for (size_t r = 0; r < n; r++)
+            for (uint64_t i = offsets_[r]; i < offsets_[r + 1]; i++)
+                masks_[r] |= uint64_t(1) << (values_[i] - base_);
+    }
+    else if (present > 0 && values_.size() / present >= SORTED_LAYOUT_MIN_AVERAGE) {
+        layout_ = ValueLayout::SORTED;
+        sorted_ = values_;
+        for (size_t r = 0; r < n; r++)
+            std::sort(sorted_.begin() + static_cast<ptrdiff_t>(offsets_[r]),
+                sorted_.begin() + static_cast<ptrdiff_t>(offsets_[r + 1]));
+    }
+}
+
+/*
+ * Method: fillOffsets
+ * -------------------
+ * Sets the offset of the records [first, last) of a packed column.
+ */
+void PropertyColumn::fillOffsets(size_t first, size_t last, uint64_t offset) {
+    for (size_t r = first; r < last; r++) {
+        if (!offsets_.empty())
+            offsets_[r] = offset;
+        else
+            offsetDeltas_.set(r, static_cast<int>(offset - blockOffsets_[r >> 6]));
+    }
+}
+
+/*
+ * Method: valueBytes
+ * ------------------
+ * Size of the value array and of the layout built on top of it.
+ */
+size_t PropertyColumn::valueBytes() const {
+    return packed_.bytes() + (values_.size() + scalars_.size() + sorted_.size()) * sizeof(int)
+        + masks_.size() * sizeof(uint64_t);
+}
+
+/*
+ * Method: indexBytes
+ * ------------------
+ * Size of the presence bits and of the plain or packed offsets.
+ */
+size_t PropertyColumn::indexBytes() const {
+    return (presence_.size() + offsets_.size() + blockOffsets_.size()) * sizeof(uint64_t)
+        + offsetDeltas_.bytes();
+}
+
+/*
+ * Method: readValues
+ * ------------------
+ * Copies the values of one record, unpacking them if needed.
+ */
+void PropertyColumn::readValues(size_t record, IntList& out) const {
+    out.resize(count(record));
+    if (layout_ == ValueLayout::PACKED)
+        packed_.decode(static_cast<size_t>(offset(record)), out.size(), out.data());
+    else
+        std::copy_n(values_.begin() + static_cast<ptrdiff_t>(offsets_[record]), out.size(), out.data());
+}
+
+/*
+ * Method: contains
+ * ----------------
+ * Looks the value up in the representation chosen by inferLayout:
+ * O(1) for SCALAR and BITSET, O(log n) for SORTED, O(n) for LISTS
+ * and PACKED (a vector of ints or a word of packed values at a time).
+ */
+bool PropertyColumn::contains(size_t record, int value) const {
+    switch (layout_) {
+    case ValueLayout::SCALAR:
+        return scalars_[record] == value;
+
+    case ValueLayout::BITSET: {
+        uint64_t bit = static_cast<uint64_t>(static_cast<int64_t>(value) - base_);
+        return bit < 64 && ((masks_[record] >> bit) & 1);
+    }
+
+    case ValueLayout::SORTED:
+        return std::binary_search(sorted_.begin() + static_cast<ptrdiff_t>(offsets_[record]),
+            sorted_.begin() + static_cast<ptrdiff_t>(offsets_[record + 1]), value);
+
+    case ValueLayout::PACKED:
+        return packed_.contains(static_cast<size_t>(offset(record)),
+            static_cast<size_t>(offset(record + 1)), value);
+
+    default: {
+        PropertyValues values = this->values(record);
+        return contains_value(values.data, values.count, value);
+    }
+    }
+}
+
+/*
+ * Method: equals
+ * --------------
+ * Compares the values of one record with a list, in order.
+ */
+bool PropertyColumn::equals(size_t record, const int* values, size_t count) const {
+    if (layout_ == ValueLayout::PACKED)
+        return packed_.equals(static_cast<size_t>(offset(record)),
+            static_cast<size_t>(offset(record + 1)), values, count);
+    PropertyValues own = this->values(record);
+    return own.size() == count && equal_values(own.data, values, count);
+}
+
+/*
+ * Method: column
+ * --------------
+ * Direct lookup by property id.
+ */
+const PropertyColumn* RecordStore::column(PropertyId id) const {
+    if (id >= columnIndex_.size() || columnIndex_[id] < 0)
+        return nullptr;
+    return &columns_[columnIndex_[id]];
+}
+
+/*
+ * Method: valueBytes
+ * ------------------
+ * Sums the value storage of all columns.
+ */
+size_t RecordStore::valueBytes() const {
+    size_t bytes = 0;
+    for (const auto& column : columns_)
+        bytes += column.valueBytes();
+    return bytes;
+}
+
+/*
+ * Method: indexBytes
+ * ------------------
+ * Sums the presence bits and offsets of all columns.
+ */
+size_t RecordStore::indexBytes() const {
+    size_t bytes = 0;
+    for (const auto& column : columns_)
+        bytes += column.indexBytes();
+    return bytes;
+}
@@ -0,0 +1,224 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "PackedInts.h"
+#include "Record.h"
+
+class RecordSnapshot;
+
+/*
+ * File: RecordStore.h
+ * -------------------
+ * In-memory columnar store of parsed records, the data source of
+ * classification.
+ *
+ * Records are stored column-wise instead of as independent objects:
+ *
+ *   names       : one arena with the record names, and n + 1 offsets
+ *   per property: a presence bitmap (bit r set if record r has it),
+ *                 n + 1 value offsets (CSR: record r owns the values
+ *                 [offsets[r], offsets[r + 1]) of the column) and one
+ *                 contiguous int array with the values of all records
+ *
+ * A scan over one property touches only that property's memory, and
+ * the bitmap and offsets are plain arrays that loops can vectorize. A
+ * record without the property has an empty range in the column.
+ *
+ * After the columns are built, a schema inference pass looks at the
+ * shape of each property over all records and adds a second, specialized
+ * representation of its values (see ValueLayout) that answers "does the
+ * record contain value v" without scanning the list.
+ *
+ * Optionally (ValueStorage::PACKED) the value arrays are bit-packed
+ * instead, trading the specialized layouts for memory: small codes take
+ * 8 bits or less instead of 32, and rules are evaluated on the packed
+ * words without unpacking them. The offsets are packed too: one 64-bit
+ * offset per 64 records, plus each record's distance from it in a few
+ * bits. Packed values are written straight from the records, without a
+ * plain copy in between.
+ */
+
+/*
+ * Enum: ValueStorage
+ * ------------------
+ * How a RecordStore keeps the values of its columns.
+ *
+ * Possible values:
+ *   - PLAIN  : 32-bit ints plus the layout picked by schema inference.
+ *   - PACKED : frame-of-reference bit-packed ints (see PackedInts.h),
+ *              with packed offsets.
+ */
+enum class ValueStorage {
+    PLAIN,
+    PACKED
+};
+
+/*
+ * Enum: ValueLayout
+ * -----------------
+ * Specialized representation of a property column, chosen by inference.
+ *
+ * Possible values:
+ *   - LISTS  : no specialization; values are scanned linearly.
+ *   - SCALAR : every record with the property has exactly one value;
+ *              one int per record, compared directly.
+ *   - BITSET : all values lie in a window of 64 consecutive integers;
+ *              one bit mask per record, a lookup is a bit test.
+ *   - SORTED : long lists; a sorted copy of each record's values,
+ *              searched by binary search.
+ *   - PACKED : values are bit-packed (ValueStorage::PACKED) and searched
+ *              in packed form.
+ */
+enum class ValueLayout {
+    LISTS,
+    SCALAR,
+    BITSET,
+    SORTED,
+    PACKED
+};
+
+// Smallest average list length for which a column gets the SORTED layout
+const size_t SORTED_LAYOUT_MIN_AVERAGE = 16;
+
+/*
+ * Class: PropertyColumn
+ * ---------------------
+ * Values of one property for all records of a store.
+ */
+class PropertyColumn {
+public:
+    // True if the record has this property
+    bool has(size_t record) const {
+        return (presence_[record >> 6] >> (record & 63)) & 1;
+    }
+
+    // Number of records that have the property
+    size_t presentCount() const { return presentCount_; }
+
+    // Index of the first value of a record in the column's values
+    uint64_t offset(size_t record) const {
+        if (!offsets_.empty()) return offsets_[record];
+        return blockOffsets_[record >> 6] + static_cast<uint32_t>(offsetDeltas_[record]);
+    }
+
+    // Number of values of the property in a record
+    size_t count(size_t record) const {
+        return static_cast<size_t>(offset(record + 1) - offset(record));
+    }
+
+    // Number of values of the property in all records
+    uint64_t valueCount() const { return offset(records_); }
+
+    // Values of the property in a record (empty if it lacks the property).
+    // Not available for PACKED columns: use readValues.
+    PropertyValues values(size_t record) const {
+        return { values_.data() + offsets_[record],
+            static_cast<size_t>(offsets_[record + 1] - offsets_[record]) };
+    }
+
+    // Copies the values of the property in a record to out (any layout)
+    void readValues(size_t record, IntList& out) const;
+
+    // True if the record contains value; the record must have the property
+    bool contains(size_t record, int value) const;
+
+    // True if the values of the property in a record equal values[0 .. count)
+    bool equals(size_t record, const int* values, size_t count) const;
+
+    // Specialized representation chosen by schema inference
+    ValueLayout layout() const { return layout_; }
+
+    // Raw columns: presence bits (64 records per word), CSR offsets and
+    // values (both empty when packed)
+    const std::vector<uint64_t>& presence() const { return presence_; }
+    const std::vector<uint64_t>& offsets() const { return offsets_; }
+    const std::vector<int>& data() const { return values_; }
+
+private:
+    friend class RecordStore;
+
+    // Picks the layout from the shape of the values and builds it
+    void inferLayout();
+
+    // Sets the offset of the records [first, last) of a packed column
+    void fillOffsets(size_t first, size_t last, uint64_t offset);
+
+    // Bytes used by the values and their layout
+    size_t valueBytes() const;
+
+    // Bytes used by the presence bits and the offsets
+    size_t indexBytes() const;
+
+    std::vector<uint64_t> presence_;
+    std::vector<uint64_t> offsets_;      // PLAIN: n + 1 offsets
+    std::vector<uint64_t> blockOffsets_; // PACKED: offset of records 64 * i
+    PackedInts offsetDeltas_;            // PACKED: offset - block offset, n + 1
+    std::vector<int> values_;
+    size_t presentCount_ = 0;
+    size_t records_ = 0;                 // Records of the store
+
+    ValueLayout layout_ = ValueLayout::LISTS;
+    std::vector<int> scalars_;           // SCALAR: value of each record
+    std::vector<uint64_t> masks_;        // BITSET: bit v - base_ per record
+    int base_ = 0;                       // BITSET: smallest value
+    std::vector<int> sorted_;            // SORTED: values_, sorted per record
+    PackedInts packed_;                  // PACKED: replaces values_
+};
+
+/*
+ * Class: RecordStore
+ * ------------------
+ * Column-wise copy of a list of records, or of a snapshot. Record ids
+ * are the indices of the records in the list or snapshot they were
+ * built from.
+ *
+ * Example:
+ *   RecordStore store(records);
+ *   const PropertyColumn* color = store.column(intern_property("color"));
+ *   for (size_t r = 0; r < store.size(); r++)
+ *       if (color && color->has(r)) { ... color->values(r) ... }
+ */
+class RecordStore {
+public:
+    RecordStore() = default;
+    explicit RecordStore(const std::vector<Record>& records,
+        ValueStorage storage = ValueStorage::PLAIN);
+
+    // Same columns, read from a loaded snapshot (which may go away after)
+    explicit RecordStore(const RecordSnapshot& snapshot,
+        ValueStorage storage = ValueStorage::PLAIN);
+
+    // Number of records
+    size_t size() const { return nameOffsets_.size() - 1; }
+
+    // Name of a record
+    std::string_view name(size_t record) const {
+        return std::string_view(names_).substr(static_cast<size_t>(nameOffsets_[record]),
+            static_cast<size_t>(nameOffsets_[record + 1] - nameOffsets_[record]));
+    }
+
+    // Column of a property, or nullptr if no record has the property
+    const PropertyColumn* column(PropertyId id) const;
+
+    // Ids of the properties that have a column, in order of first use
+    const std::vector<PropertyId>& properties() const { return columnIds_; }
+
+    // Bytes used by the values of all columns (without offsets and bitmaps)
+    size_t valueBytes() const;
+
+    // Bytes used by the presence bitmaps and offsets of all columns
+    size_t indexBytes() const;
+
+private:
+    // Lays out the records of a source (see RecordStore.cpp)
+    template <class Source>
+    void build(const Source& source, ValueStorage storage);
+
+    std::string names_;
+    std::vector<uint64_t> nameOffsets_{ 0 };
+    std::vector<PropertyColumn> columns_;
+    std::vector<PropertyId> columnIds_;  // Property of each column
+    std::vector<int32_t> columnIndex_;   // By PropertyId, -1 if no column
+};
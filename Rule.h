@@ -1,6 +1,11 @@
 #pragma once
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
+#include "PropertyDictionary.h"
+#include "SmallVector.h"
 
 /*
  * Enum: RuleType
@@ -27,17 +32,78 @@ enum RuleType {
  *
  * Fields:
  *   - type                : the type of rule (from RuleType).
- *   - propertyName        : the property to which this rule applies.
+ *   - propertyName        : the property to which this rule applies, as written.
  *   - expectedSize        : expected number of values (used for PROPERTY_SIZE).
  *   - expectedValue       : specific value to check (used for CONTAINS_VALUE).
  *   - expectedExactValues : full list of values to match (used for EQUALS_EXACTLY).
+ *   - propertyId          : interned id of propertyName, used for matching.
+ *
+ * The name and its id are kept together: set them through the constructor
+ * or setProperty, never by assigning propertyName alone.
  */
 struct Rule {
-    RuleType type;                        // Type of the rule
+    RuleType type = HAS_PROPERTY;         // Type of the rule
     std::string propertyName;             // Target property name
     int expectedSize = 0;                 // For PROPERTY_SIZE
     int expectedValue = 0;                // For CONTAINS_VALUE
-    std::vector<int> expectedExactValues; // For EQUALS_EXACTLY
+    IntList expectedExactValues;          // For EQUALS_EXACTLY
+    PropertyId propertyId = NO_PROPERTY;  // Interned propertyName
+
+    Rule() = default;
+    Rule(RuleType type, std::string_view propertyName, int expectedSize = 0,
+        int expectedValue = 0, IntList expectedExactValues = {})
+        : type(type), expectedSize(expectedSize), expectedValue(expectedValue),
+        expectedExactValues(std::move(expectedExactValues)) {
+        setProperty(propertyName);
+    }
+
+    // Sets the target property and interns its name
+    void setProperty(std::string_view name) {
+        propertyName.assign(name);
+        propertyId = intern_property(name);
+    }
+};
+
+/*
+ * Function: same_rule
+ * -------------------
+ * True if two rules accept exactly the same records: same type, same
+ * property (by id, so names differing in case are the same property)
+ * and same operand for that type. Fields the type does not use are
+ * ignored.
+ */
+inline bool same_rule(const Rule& a, const Rule& b) {
+    if (a.type != b.type || a.propertyId != b.propertyId) return false;
+    switch (a.type) {
+    case PROPERTY_SIZE:  return a.expectedSize == b.expectedSize;
+    case CONTAINS_VALUE: return a.expectedValue == b.expectedValue;
+    case EQUALS_EXACTLY: return a.expectedExactValues == b.expectedExactValues;
+    default:             return true;
+    }
+}
+
+/*
+ * Structures: RuleHash, RuleEqual
+ * -------------------------------
+ * Hash and equality of rule identity (see same_rule), for keying
+ * unordered containers by rule.
+ */
+struct RuleHash {
+    size_t operator()(const Rule& r) const {
+        size_t h = (static_cast<size_t>(r.propertyId) << 2) ^ static_cast<size_t>(r.type);
+        auto mix = [&h](int v) { h = (h ^ static_cast<size_t>(static_cast<unsigned>(v))) * 0x100000001B3ull; };
+        switch (r.type) {
+        case PROPERTY_SIZE:  mix(r.expectedSize); break;
+        case CONTAINS_VALUE: mix(r.expectedValue); break;
+        case EQUALS_EXACTLY: for (int v : r.expectedExactValues) mix(v); break;
+        default: break;
+        }
+        return h;
+    }
+};
+
+struct RuleEqual {
+    bool operator()(const Rule& a, const Rule& b) const { return same_rule(a, b); }
 };
 
 /*
@@ -0,0 +1,194 @@
+/*
+ * File: RuleCache.cpp
+ * -------------------
+ * Writes and loads compiled ruleset caches.
+ */
+
+#include "RuleCache.h"
+#include "BinaryFormat.h"
+#include <cstring>
+#include <fstream>
+
+static const char RULE_CACHE_MAGIC[8] = { 'F', 'R', 'R', 'U', 'L', 'E', 'S', '\0' };
+
+// Fields stored per diagnostic
+static const uint64_t DIAGNOSTIC_FIELDS = 5;
+
+/*
+ * Function: write_rule_cache
+ * --------------------------
+ * Lays the classes and rules out in columns and writes header and
+ * sections in file order.
+ */
+bool write_rule_cache(const std::string& path, std::string_view source,
+    const std::vector<ClassRule>& classes, const std::vector<RuleDiagnostic>& rejected) {
+    // Step 1: Build the class and rule columns
+    std::vector<uint64_t> classNameOffsets{ 0 }, classRules{ 0 }, ruleNameOffsets{ 0 }, exactOffsets{ 0 };
+    std::vector<uint32_t> ruleTypes;
+    std::vector<int32_t> ruleSizes, ruleValues, exactValues;
+    std::string classNames, ruleNames;
+    for (const auto& c : classes) {
+        classNames.append(c.className);
+        classNameOffsets.push_back(classNames.size());
+
+        for (const auto& r : c.rules) {
+            ruleNames.append(r.propertyName);
+            ruleNameOffsets.push_back(ruleNames.size());
+            ruleTypes.push_back(static_cast<uint32_t>(r.type));
+            ruleSizes.push_back(r.expectedSize);
+            ruleValues.push_back(r.expectedValue);
+            exactValues.insert(exactValues.end(), r.expectedExactValues.begin(), r.expectedExactValues.end());
+            exactOffsets.push_back(exactValues.size());
+        }
+        classRules.push_back(ruleTypes.size());
+    }
+
+    // Step 2: Diagnostics refer to their line by its range in source
+    std::vector<uint64_t> diagnostics;
+    for (const auto& d : rejected) {
+        diagnostics.insert(diagnostics.end(), { d.line, d.column, static_cast<uint64_t>(d.code),
+            static_cast<uint64_t>(d.text.data() - source.data()), d.text.size() });
+    }
+
+    // Step 3: Fill in the header
+    RuleCacheHeader header{};
+    std::memcpy(header.magic, RULE_CACHE_MAGIC, sizeof(RULE_CACHE_MAGIC));
+    header.version = RULE_CACHE_VERSION;
+    header.byteOrder = BINARY_BYTE_ORDER;
+    header.sourceSize = source.size();
+    header.sourceHash = content_hash(source);
+    header.classCount = classes.size();
+    header.ruleCount = ruleTypes.size();
+    header.exactCount = exactValues.size();
+    header.diagnosticCount = rejected.size();
+    header.classNameBytes = classNames.size();
+    header.ruleNameBytes = ruleNames.size();
+    header.fileSize = sizeof(RuleCacheHeader)
+        + padded(classNameOffsets.size() * sizeof(uint64_t))
+        + padded(classRules.size() * sizeof(uint64_t))
+        + padded(ruleNameOffsets.size() * sizeof(uint64_t))
+        + padded(exactOffsets.size() * sizeof(uint64_t))
+        + padded(ruleTypes.size() * sizeof(uint32_t))
+        + padded(ruleSizes.size() * sizeof(int32_t))
+        + padded(ruleValues.size() * sizeof(int32_t))
+        + padded(exactValues.size() * sizeof(int32_t))
+        + padded(diagnostics.size() * sizeof(uint64_t))
+        + padded(classNames.size())
+        + padded(ruleNames.size());
+
+    // Step 4: Write header and sections
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_section(out, classNameOffsets.data(), classNameOffsets.size() * sizeof(uint64_t));
+    write_section(out, classRules.data(), classRules.size() * sizeof(uint64_t));
+    write_section(out, ruleNameOffsets.data(), ruleNameOffsets.size() * sizeof(uint64_t));
+    write_section(out, exactOffsets.data(), exactOffsets.size() * sizeof(uint64_t));
+    write_section(out, ruleTypes.data(), ruleTypes.size() * sizeof(uint32_t));
+    write_section(out, ruleSizes.data(), ruleSizes.size() * sizeof(int32_t));
+    write_section(out, ruleValues.data(), ruleValues.size() * sizeof(int32_t));
+    write_section(out, exactValues.data(), exactValues.size() * sizeof(int32_t));
+    write_section(out, diagnostics.data(), diagnostics.size() * sizeof(uint64_t));
+    write_section(out, classNames.data(), classNames.size());
+    write_section(out, ruleNames.data(), ruleNames.size());
+
+    out.close();
+    return !out.fail();
+}
+
+/*
+ * Function: load_rule_cache
+ * -------------------------
+ * Checks the header against the buffer and the source text, validates
+ * every offset and code, and only then materializes the classes.
+ */
+bool load_rule_cache(std::string_view cache, std::string_view source,
+    std::vector<ClassRule>& classes, ErrorSink& errors, std::vector<RuleDiagnostic>& rejected) {
+    // Step 1: Header, and the key of the cache
+    RuleCacheHeader h;
+    if (cache.size() < sizeof(h) || reinterpret_cast<uintptr_t>(cache.data()) % 8 != 0)
+        return false;
+    std::memcpy(&h, cache.data(), sizeof(h));
+    if (std::memcmp(h.magic, RULE_CACHE_MAGIC, sizeof(RULE_CACHE_MAGIC)) != 0 ||
+        h.version != RULE_CACHE_VERSION || h.byteOrder != BINARY_BYTE_ORDER ||
+        h.sourceSize != source.size() || h.sourceHash != content_hash(source))
+        return false;
+
+    // Step 2: Section sizes must add up to the file size
+    const uint64_t size = cache.size();
+    if (h.fileSize != size || h.classCount >= size / 8 || h.ruleCount >= size / 8 ||
+        h.exactCount > size / 4 || h.diagnosticCount > size / (8 * DIAGNOSTIC_FIELDS) ||
+        h.classNameBytes > size || h.ruleNameBytes > size)
+        return false;
+    uint64_t expected = sizeof(RuleCacheHeader)
+        + 2 * padded((h.classCount + 1) * sizeof(uint64_t))
+        + 2 * padded((h.ruleCount + 1) * sizeof(uint64_t))
+        + 3 * padded(h.ruleCount * sizeof(uint32_t))
+        + padded(h.exactCount * sizeof(int32_t))
+        + padded(h.diagnosticCount * DIAGNOSTIC_FIELDS * sizeof(uint64_t))
+        + padded(h.classNameBytes)
+        + padded(h.ruleNameBytes);
+    if (expected != size)
+        return false;
+
+    // Step 3: Column pointers, in file order
+    const char* p = cache.data() + sizeof(RuleCacheHeader);
+    auto take = [&p](uint64_t bytes) { const char* s = p; p += padded(bytes); return s; };
+    auto classNameOffsets = reinterpret_cast<const uint64_t*>(take((h.classCount + 1) * sizeof(uint64_t)));
+    auto classRules = reinterpret_cast<const uint64_t*>(take((h.classCount + 1) * sizeof(uint64_t)));
+    auto ruleNameOffsets = reinterpret_cast<const uint64_t*>(take((h.ruleCount + 1) * sizeof(uint64_t)));
+    auto exactOffsets = reinterpret_cast<const uint64_t*>(take((h.ruleCount + 1) * sizeof(uint64_t)));
+    auto ruleTypes = reinterpret_cast<const uint32_t*>(take(h.ruleCount * sizeof(uint32_t)));
+    auto ruleSizes = reinterpret_cast<const int32_t*>(take(h.ruleCount * sizeof(int32_t)));
+    auto ruleValues = reinterpret_cast<const int32_t*>(take(h.ruleCount * sizeof(int32_t)));
+    auto exactValues = reinterpret_cast<const int32_t*>(take(h.exactCount * sizeof(int32_t)));
+    auto diagnostics = reinterpret_cast<const uint64_t*>(take(h.diagnosticCount * DIAGNOSTIC_FIELDS * sizeof(uint64_t)));
+    const char* classNames = take(h.classNameBytes);
+    const char* ruleNames = take(h.ruleNameBytes);
+
+    // Step 4: Offsets stay inside their sections, codes are known and
+    // diagnostic texts lie inside the source
+    if (!offsets_valid(classNameOffsets, h.classCount, h.classNameBytes) ||
+        !offsets_valid(classRules, h.classCount, h.ruleCount) ||
+        !offsets_valid(ruleNameOffsets, h.ruleCount, h.ruleNameBytes) ||
+        !offsets_valid(exactOffsets, h.ruleCount, h.exactCount))
+        return false;
+    for (uint64_t i = 0; i < h.ruleCount; i++)
+        if (ruleTypes[i] > EQUALS_EXACTLY) return false;
+    for (uint64_t i = 0; i < h.diagnosticCount; i++) {
+        const uint64_t* d = diagnostics + i * DIAGNOSTIC_FIELDS;
+        if (d[2] > static_cast<uint64_t>(ErrorCode::INVALID_VALUE_IN_CONTAINS_VALUE) ||
+            d[3] > source.size() || d[4] > source.size() - d[3])
+            return false;
+    }
+
+    // Step 5: Materialize the classes
+    for (uint64_t c = 0; c < h.classCount; c++) {
+        ClassRule cr;
+        cr.className.assign(classNames + classNameOffsets[c], classNameOffsets[c + 1] - classNameOffsets[c]);
+        for (uint64_t i = classRules[c]; i < classRules[c + 1]; i++) {
+            Rule r;
+            r.type = static_cast<RuleType>(ruleTypes[i]);
+            r.setProperty(std::string_view(ruleNames + ruleNameOffsets[i], ruleNameOffsets[i + 1] - ruleNameOffsets[i]));
+            r.expectedSize = ruleSizes[i];
+            r.expectedValue = ruleValues[i];
+            r.expectedExactValues.assign(exactValues + exactOffsets[i], exactValues + exactOffsets[i + 1]);
+            cr.rules.push_back(std::move(r));
+        }
+        classes.push_back(std::move(cr));
+    }
+
+    // Step 6: Replay the diagnostics in line order, as parse_rules would
+    for (uint64_t i = 0; i < h.diagnosticCount; i++) {
+        const uint64_t* d = diagnostics + i * DIAGNOSTIC_FIELDS;
+        RuleDiagnostic diag;
+        diag.line = static_cast<size_t>(d[0]);
+        diag.column = static_cast<size_t>(d[1]);
+        diag.code = static_cast<ErrorCode>(d[2]);
+        diag.text = source.substr(static_cast<size_t>(d[3]), static_cast<size_t>(d[4]));
+        rejected.push_back(diag);
+        errors.report(diag.code, "Parser", diag.line, diag.column);
+    }
+    return true;
+}
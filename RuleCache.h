@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Rule.h"
+#include "ErrorSink.h"
+#include "Parser.h"
+
+/*
+ * File: RuleCache.h
+ * -----------------
+ * Compiled ruleset cache.
+ *
+ * The cache holds everything main() derives from rules.txt: the parsed
+ * classes and rules, and the rejected lines with their diagnostics. It
+ * is keyed by the size and content hash of the rules text it was built
+ * from; loading a cache for different text fails, and the caller then
+ * parses the rules and rewrites the cache. Only rulesets that pass
+ * validate_classes are cached, so a loaded ruleset needs no validation.
+ *
+ * Layout (native byte order, every section 8-byte aligned):
+ *
+ *   RuleCacheHeader
+ *   uint64 classNameOffsets[classCount + 1]  into classNames
+ *   uint64 classRules      [classCount + 1]  into the rule columns
+ *   uint64 ruleNameOffsets [ruleCount + 1]   into ruleNames
+ *   uint64 exactOffsets    [ruleCount + 1]   into exactValues
+ *   uint32 ruleTypes       [ruleCount]
+ *   int32  ruleSizes       [ruleCount]
+ *   int32  ruleValues      [ruleCount]
+ *   int32  exactValues     [exactCount]
+ *   uint64 diagnostics     [diagnosticCount * 5]
+ *                          (line, column, code, text offset, text length;
+ *                           the text is a range of the rules file)
+ *   char   classNames      [classNameBytes]
+ *   char   ruleNames       [ruleNameBytes]
+ */
+
+// Version of the cache layout; bumped on every incompatible change
+const uint32_t RULE_CACHE_VERSION = 1;
+
+/*
+ * Structure: RuleCacheHeader
+ * --------------------------
+ * Fixed-size header at the start of a rule cache file.
+ */
+struct RuleCacheHeader {
+    char magic[8];             // "FRRULES" followed by '\0'
+    uint32_t version;          // RULE_CACHE_VERSION
+    uint32_t byteOrder;        // BINARY_BYTE_ORDER in the writer's byte order
+    uint64_t sourceSize;       // Size of the rules text
+    uint64_t sourceHash;       // content_hash of the rules text
+    uint64_t classCount;       // Number of classes
+    uint64_t ruleCount;        // Number of rules of all classes
+    uint64_t exactCount;       // Total number of EQUALS_EXACTLY values
+    uint64_t diagnosticCount;  // Number of rejected lines
+    uint64_t classNameBytes;   // Size of the class name bytes
+    uint64_t ruleNameBytes;    // Size of the property name bytes
+    uint64_t fileSize;         // Size of the whole file
+};
+
+/*
+ * Function: write_rule_cache
+ * --------------------------
+ * Writes the ruleset parsed from source into a cache file at path.
+ *
+ * Returns:
+ *   true  on success,
+ *   false if the file cannot be created or written.
+ */
+bool write_rule_cache(const std::string& path, std::string_view source,
+    const std::vector<ClassRule>& classes, const std::vector<RuleDiagnostic>& rejected);
+
+/*
+ * Function: load_rule_cache
+ * -------------------------
+ * Restores the ruleset of source from cache bytes (typically a mapped
+ * cache file). Errors are reported again from the stored diagnostics,
+ * with their lines and columns, and the diagnostic texts are views into
+ * source.
+ *
+ * Returns:
+ *   true  if the cache is valid and was built from exactly this source,
+ *   false otherwise (nothing is added to the outputs).
+ */
+bool load_rule_cache(std::string_view cache, std::string_view source,
+    std::vector<ClassRule>& classes, ErrorSink& errors, std::vector<RuleDiagnostic>& rejected);
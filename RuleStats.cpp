@@ -0,0 +1,243 @@
+/*
+ * File: RuleStats.cpp
+ * -------------------
+ * Collects, persists and applies rule pass rates.
+ */
+
+#include "RuleStats.h"
+#include "BinaryFormat.h"
+#include "Matching.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+static const char RULE_STATS_MAGIC[8] = { 'F', 'R', 'S', 'T', 'A', 'T', 'S', '\0' };
+
+// Lower bound of the rejection rate in the rank, so that rules that
+// always pass still sort by cost
+static const double MIN_REJECT_RATE = 1e-3;
+
+/*
+ * Constructor: RuleStats
+ * ----------------------
+ * Starts every rule of the table without history.
+ */
+RuleStats::RuleStats(const RuleTable& table)
+    : table_(table), evaluated_(table.ruleCount(), 0), passed_(table.ruleCount(), 0) {}
+
+/*
+ * Method: sample
+ * --------------
+ * Evaluates all distinct rules on every step-th record, so the sample
+ * covers the whole file rather than its first lines.
+ */
+void RuleStats::sample(const RecordStore& store, size_t maxRecords) {
+    if (store.size() == 0 || maxRecords == 0) return;
+    const size_t step = std::max<size_t>(1, store.size() / maxRecords);
+    for (size_t r = 0; r < store.size(); r += step)
+        for (uint32_t id = 0; id < table_.ruleCount(); id++)
+            add(id, match_rule(store, r, table_.rule(id)));
+}
+
+/*
+ * Method: passRate
+ * ----------------
+ * Rules never evaluated are assumed to pass half of the time.
+ */
+double RuleStats::passRate(uint32_t id) const {
+    if (evaluated_[id] == 0) return 0.5;
+    return static_cast<double>(passed_[id]) / static_cast<double>(evaluated_[id]);
+}
+
+/*
+ * Method: save
+ * ------------
+ * Lays the rules out in columns, as the rule cache does, next to their
+ * counts.
+ */
+bool RuleStats::save(const std::string& path) const {
+    // Step 1: Build the rule columns
+    std::vector<uint64_t> nameOffsets{ 0 }, exactOffsets{ 0 };
+    std::vector<uint32_t> ruleTypes;
+    std::vector<int32_t> ruleSizes, ruleValues, exactValues;
+    std::string names;
+    for (uint32_t id = 0; id < table_.ruleCount(); id++) {
+        const Rule& r = table_.rule(id);
+        names.append(r.propertyName);
+        nameOffsets.push_back(names.size());
+        ruleTypes.push_back(static_cast<uint32_t>(r.type));
+        ruleSizes.push_back(r.expectedSize);
+        ruleValues.push_back(r.expectedValue);
+        exactValues.insert(exactValues.end(), r.expectedExactValues.begin(), r.expectedExactValues.end());
+        exactOffsets.push_back(exactValues.size());
+    }
+
+    // Step 2: Fill in the header
+    RuleStatsHeader header{};
+    std::memcpy(header.magic, RULE_STATS_MAGIC, sizeof(RULE_STATS_MAGIC));
+    header.version = RULE_STATS_VERSION;
+    header.byteOrder = BINARY_BYTE_ORDER;
+    header.ruleCount = ruleTypes.size();
+    header.exactCount = exactValues.size();
+    header.nameBytes = names.size();
+    header.fileSize = sizeof(RuleStatsHeader)
+        + padded(nameOffsets.size() * sizeof(uint64_t))
+        + padded(exactOffsets.size() * sizeof(uint64_t))
+        + padded(evaluated_.size() * sizeof(uint64_t))
+        + padded(passed_.size() * sizeof(uint64_t))
+        + padded(ruleTypes.size() * sizeof(uint32_t))
+        + padded(ruleSizes.size() * sizeof(int32_t))
+        + padded(ruleValues.size() * sizeof(int32_t))
+        + padded(exactValues.size() * sizeof(int32_t))
+        + padded(names.size());
+
+    // Step 3: Write header and sections
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_section(out, nameOffsets.data(), nameOffsets.size() * sizeof(uint64_t));
+    write_section(out, exactOffsets.data(), exactOffsets.size() * sizeof(uint64_t));
+    write_section(out, evaluated_.data(), evaluated_.size() * sizeof(uint64_t));
+    write_section(out, passed_.data(), passed_.size() * sizeof(uint64_t));
+    write_section(out, ruleTypes.data(), ruleTypes.size() * sizeof(uint32_t));
+    write_section(out, ruleSizes.data(), ruleSizes.size() * sizeof(int32_t));
+    write_section(out, ruleValues.data(), ruleValues.size() * sizeof(int32_t));
+    write_section(out, exactValues.data(), exactValues.size() * sizeof(int32_t));
+    write_section(out, names.data(), names.size());
+
+    out.close();
+    return !out.fail();
+}
+
+/*
+ * Method: load
+ * ------------
+ * Validates the whole file before touching any count, then looks each
+ * stored rule up in the table by identity.
+ *
+ * Returns:
+ *   true  if the file is a valid stats file,
+ *   false otherwise (no count changes).
+ */
+bool RuleStats::load(std::string_view data) {
+    // Step 1: Header
+    RuleStatsHeader h;
+    if (data.size() < sizeof(h) || reinterpret_cast<uintptr_t>(data.data()) % 8 != 0)
+        return false;
+    std::memcpy(&h, data.data(), sizeof(h));
+    if (std::memcmp(h.magic, RULE_STATS_MAGIC, sizeof(RULE_STATS_MAGIC)) != 0 ||
+        h.version != RULE_STATS_VERSION || h.byteOrder != BINARY_BYTE_ORDER)
+        return false;
+
+    // Step 2: Section sizes must add up to the file size
+    const uint64_t size = data.size();
+    if (h.fileSize != size || h.ruleCount >= size / 8 || h.exactCount > size / 4 || h.nameBytes > size)
+        return false;
+    uint64_t expected = sizeof(RuleStatsHeader)
+        + 2 * padded((h.ruleCount + 1) * sizeof(uint64_t))
+        + 2 * padded(h.ruleCount * sizeof(uint64_t))
+        + 3 * padded(h.ruleCount * sizeof(uint32_t))
+        + padded(h.exactCount * sizeof(int32_t))
+        + padded(h.nameBytes);
+    if (expected != size)
+        return false;
+
+    // Step 3: Column pointers, in file order
+    const char* p = data.data() + sizeof(RuleStatsHeader);
+    auto take = [&p](uint64_t bytes) { const char* s = p; p += padded(bytes); return s; };
+    auto nameOffsets = reinterpret_cast<const uint64_t*>(take((h.ruleCount + 1) * sizeof(uint64_t)));
+    auto exactOffsets = reinterpret_cast<const uint64_t*>(take((h.ruleCount + 1) * sizeof(uint64_t)));
+    auto evaluated = reinterpret_cast<const uint64_t*>(take(h.ruleCount * sizeof(uint64_t)));
+    auto passed = reinterpret_cast<const uint64_t*>(take(h.ruleCount * sizeof(uint64_t)));
+    auto ruleTypes = reinterpret_cast<const uint32_t*>(take(h.ruleCount * sizeof(uint32_t)));
+    auto ruleSizes = reinterpret_cast<const int32_t*>(take(h.ruleCount * sizeof(int32_t)));
+    auto ruleValues = reinterpret_cast<const int32_t*>(take(h.ruleCount * sizeof(int32_t)));
+    auto exactValues = reinterpret_cast<const int32_t*>(take(h.exactCount * sizeof(int32_t)));
+    const char* names = take(h.nameBytes);
+
+    // Step 4: Offsets stay inside their sections, types are known and
+    // no rule passed more often than it was evaluated
+    if (!offsets_valid(nameOffsets, h.ruleCount, h.nameBytes) ||
+        !offsets_valid(exactOffsets, h.ruleCount, h.exactCount))
+        return false;
+    for (uint64_t i = 0; i < h.ruleCount; i++)
+        if (ruleTypes[i] > EQUALS_EXACTLY || passed[i] > evaluated[i]) return false;
+
+    // Step 5: Merge the counts of the rules the table has
+    std::unordered_map<Rule, uint32_t, RuleHash, RuleEqual> ids;
+    for (uint32_t id = 0; id < table_.ruleCount(); id++)
+        ids.emplace(table_.rule(id), id);
+    for (uint64_t i = 0; i < h.ruleCount; i++) {
+        Rule r;
+        r.type = static_cast<RuleType>(ruleTypes[i]);
+        r.setProperty(std::string_view(names + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]));
+        r.expectedSize = ruleSizes[i];
+        r.expectedValue = ruleValues[i];
+        r.expectedExactValues.assign(exactValues + exactOffsets[i], exactValues + exactOffsets[i + 1]);
+        auto it = ids.find(r);
+        if (it == ids.end()) continue;
+        evaluated_[it->second] += evaluated[i];
+        passed_[it->second] += passed[i];
+    }
+    return true;
+}
+
+/*
+ * Function: rule_cost
+ * -------------------
+ * Units are roughly "one memory access". Every rule first tests the
+ * presence bit; a property no record has is rejected right there.
+ */
+double rule_cost(const Rule& rule, const RecordStore* store) {
+    const PropertyColumn* column = store ? store->column(rule.propertyId) : nullptr;
+    if (store && column == nullptr) return 1.0;
+
+    switch (rule.type) {
+    case HAS_PROPERTY:
+        return 1.0;
+
+    case PROPERTY_SIZE:
+        return 1.5;
+
+    case CONTAINS_VALUE: {
+        if (column == nullptr) return 4.0;
+        const double average = column->presentCount() == 0 ? 0.0
+            : static_cast<double>(column->valueCount()) / static_cast<double>(column->presentCount());
+        switch (column->layout()) {
+        case ValueLayout::SCALAR:
+        case ValueLayout::BITSET:
+            return 1.5;
+        case ValueLayout::SORTED:
+            return 2.0 + std::log2(1.0 + average);
+        default:
+            return 1.5 + average;
+        }
+    }
+
+    case EQUALS_EXACTLY:
+        // Lists of another length are rejected by their count
+        return 2.0 + static_cast<double>(rule.expectedExactValues.size()) / 4.0;
+
+    default:
+        return 1.0;
+    }
+}
+
+/*
+ * Function: order_rules
+ * ---------------------
+ * For rules checked in sequence until one fails, running them by
+ * ascending cost / probability of failing minimizes the expected cost.
+ * Ties keep the order of the class.
+ */
+void order_rules(RuleTable& table, const RuleStats& stats, const RecordStore* store) {
+    std::vector<double> rank(table.ruleCount());
+    for (uint32_t id = 0; id < table.ruleCount(); id++) {
+        const double reject = std::max(1.0 - stats.passRate(id), MIN_REJECT_RATE);
+        rank[id] = rule_cost(table.rule(id), store) / reject;
+    }
+    table.reorder(rank);
+}
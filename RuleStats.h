@@ -0,0 +1,124 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "RecordStore.h"
+#include "RuleTable.h"
+
+/*
+ * File: RuleStats.h
+ * -----------------
+ * Pass rates of rules, and the rule order they suggest.
+ *
+ * A class matches only if all its rules do, so its rules are evaluated
+ * until the first one fails. Which rule runs first does not change the
+ * result, but it decides how much work a rejected record costs: a cheap
+ * rule that almost never passes should go before an expensive one that
+ * almost always does. RuleStats counts, per distinct rule of a
+ * RuleTable, how many records it was evaluated on and how many passed;
+ * order_rules turns those counts and a cost estimate into an order.
+ *
+ * The counts can be kept between runs in a stats file. Rules are found
+ * in it by identity (see same_rule), so the file survives edits of the
+ * rules text; rules it does not know start without history.
+ *
+ * Layout (native byte order, every section 8-byte aligned):
+ *
+ *   RuleStatsHeader
+ *   uint64 nameOffsets [ruleCount + 1]  into names
+ *   uint64 exactOffsets[ruleCount + 1]  into exactValues
+ *   uint64 evaluated   [ruleCount]
+ *   uint64 passed      [ruleCount]
+ *   uint32 ruleTypes   [ruleCount]
+ *   int32  ruleSizes   [ruleCount]
+ *   int32  ruleValues  [ruleCount]
+ *   int32  exactValues [exactCount]
+ *   char   names       [nameBytes]
+ */
+
+// Version of the stats file layout; bumped on every incompatible change
+const uint32_t RULE_STATS_VERSION = 1;
+
+// Records sampled per run to measure pass rates
+const size_t RULE_STATS_SAMPLE = 1024;
+
+/*
+ * Structure: RuleStatsHeader
+ * --------------------------
+ * Fixed-size header at the start of a stats file.
+ */
+struct RuleStatsHeader {
+    char magic[8];         // "FRSTATS" followed by '\0'
+    uint32_t version;      // RULE_STATS_VERSION
+    uint32_t byteOrder;    // BINARY_BYTE_ORDER in the writer's byte order
+    uint64_t ruleCount;    // Number of rules
+    uint64_t exactCount;   // Total number of EQUALS_EXACTLY values
+    uint64_t nameBytes;    // Size of the property name bytes
+    uint64_t fileSize;     // Size of the whole file
+};
+
+/*
+ * Class: RuleStats
+ * ----------------
+ * Evaluation and pass counts of the distinct rules of a RuleTable (by
+ * rule id). The table must outlive the stats.
+ *
+ * Example:
+ *   RuleStats stats(table);
+ *   stats.load(file.data());      // earlier runs, if any
+ *   stats.sample(store);
+ *   order_rules(table, stats, &store);
+ *   stats.save("rules.stats");
+ */
+class RuleStats {
+public:
+    explicit RuleStats(const RuleTable& table);
+
+    // Evaluates every rule on up to maxRecords evenly spaced records
+    void sample(const RecordStore& store, size_t maxRecords = RULE_STATS_SAMPLE);
+
+    // Counts one evaluation of rule id
+    void add(uint32_t id, bool passed) {
+        evaluated_[id]++;
+        passed_[id] += passed ? 1 : 0;
+    }
+
+    // Counts of rule id
+    uint64_t evaluated(uint32_t id) const { return evaluated_[id]; }
+    uint64_t passed(uint32_t id) const { return passed_[id]; }
+
+    // Share of evaluations of rule id that passed (0.5 without history)
+    double passRate(uint32_t id) const;
+
+    // Adds the counts of a stats file (typically mapped) to the rules
+    // of the table it knows
+    bool load(std::string_view data);
+
+    // Writes the counts of all rules of the table to a stats file
+    bool save(const std::string& path) const;
+
+private:
+    const RuleTable& table_;
+    std::vector<uint64_t> evaluated_;
+    std::vector<uint64_t> passed_;
+};
+
+/*
+ * Function: rule_cost
+ * -------------------
+ * Estimated relative cost of evaluating a rule on one record. With a
+ * store, CONTAINS_VALUE is priced by the layout of the property's
+ * column and its average list length; without one, by the rule type.
+ */
+double rule_cost(const Rule& rule, const RecordStore* store);
+
+/*
+ * Function: order_rules
+ * ---------------------
+ * Reorders the rules of every class of table so that rules with the
+ * lowest cost per rejected record run first (cost / (1 - pass rate)).
+ * Classification results do not change.
+ */
+void order_rules(RuleTable& table, const RuleStats& stats, const RecordStore* store);
@@ -0,0 +1,43 @@
+/*
+ * File: RuleTable.cpp
+ * -------------------
+ * Builds the table of distinct rules.
+ */
+
+#include "RuleTable.h"
+#include <algorithm>
+#include <unordered_map>
+
+/*
+ * Constructor: RuleTable
+ * ----------------------
+ * Looks every rule up by identity; the first occurrence of a rule
+ * defines its id.
+ */
+RuleTable::RuleTable(const std::vector<ClassRule>& classRules) {
+    std::unordered_map<Rule, uint32_t, RuleHash, RuleEqual> ids;
+
+    for (const auto& c : classRules) {
+        for (const auto& rule : c.rules) {
+            auto it = ids.find(rule);
+            if (it == ids.end()) {
+                it = ids.emplace(rule, static_cast<uint32_t>(rules_.size())).first;
+                rules_.push_back(rule);
+            }
+            ruleIds_.push_back(it->second);
+        }
+        classOffsets_.push_back(static_cast<uint32_t>(ruleIds_.size()));
+    }
+}
+
+/*
+ * Method: reorder
+ * ---------------
+ * Sorts each class's slice of rule ids in place.
+ */
+void RuleTable::reorder(const std::vector<double>& rank) {
+    for (size_t c = 0; c < classCount(); c++) {
+        std::stable_sort(ruleIds_.begin() + classOffsets_[c], ruleIds_.begin() + classOffsets_[c + 1],
+            [&rank](uint32_t a, uint32_t b) { return rank[a] < rank[b]; });
+    }
+}
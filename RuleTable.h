@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Rule.h"
+
+/*
+ * File: RuleTable.h
+ * -----------------
+ * Rules of all classes with duplicates merged.
+ */
+
+/*
+ * Structure: RuleIds
+ * ------------------
+ * Read-only view of the rule ids of one class.
+ */
+struct RuleIds {
+    const uint32_t* data = nullptr;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    const uint32_t* begin() const { return data; }
+    const uint32_t* end() const { return data + count; }
+};
+
+/*
+ * Class: RuleTable
+ * ----------------
+ * Compiled form of a list of classes: every distinct rule (see
+ * same_rule) is stored once and gets an id, and each class becomes a
+ * list of rule ids (CSR: class c owns ids [offsets[c], offsets[c + 1])).
+ * A rule shared by hundreds of classes is one table entry, so a record
+ * needs to be checked against it only once (see RuleMemo).
+ *
+ * Example:
+ *   RuleTable table(classes);
+ *   for (uint32_t id : table.classRules(0))
+ *       table.rule(id) ...
+ */
+class RuleTable {
+public:
+    RuleTable() = default;
+    explicit RuleTable(const std::vector<ClassRule>& classRules);
+
+    // Number of distinct rules, and of rules over all classes
+    size_t ruleCount() const { return rules_.size(); }
+    size_t instanceCount() const { return ruleIds_.size(); }
+
+    // Number of classes
+    size_t classCount() const { return classOffsets_.size() - 1; }
+
+    // Distinct rule by id
+    const Rule& rule(uint32_t id) const { return rules_[id]; }
+
+    // Ids of the rules of class c, in evaluation order (the order of the
+    // class unless reordered)
+    RuleIds classRules(size_t c) const {
+        return { ruleIds_.data() + classOffsets_[c], classOffsets_[c + 1] - classOffsets_[c] };
+    }
+
+    // Sorts the rules of every class by ascending rank[id] (stable). A
+    // class matches when all its rules do, so the order only changes
+    // how soon a failing class is rejected, never the result.
+    void reorder(const std::vector<double>& rank);
+
+private:
+    std::vector<Rule> rules_;
+    std::vector<uint32_t> classOffsets_{ 0 };
+    std::vector<uint32_t> ruleIds_;
+};
+
+/*
+ * Class: RuleMemo
+ * ---------------
+ * Results of the rules of a RuleTable for one record: a bit per rule
+ * telling whether it was evaluated, and a bit with its result. Reset
+ * before each record.
+ *
+ * Example:
+ *   memo.reset(table.ruleCount());
+ *   bool ok = memo.get(id, [&] { return match_rule(record, table.rule(id)); });
+ */
+class RuleMemo {
+public:
+    // Forgets all results; sizes the memo for ruleCount rules
+    void reset(size_t ruleCount) {
+        known_.assign((ruleCount + 63) / 64, 0);
+        value_.resize(known_.size());
+    }
+
+    // Result of rule id, calling evaluate() only the first time
+    template <class Evaluate>
+    bool get(uint32_t id, Evaluate evaluate) {
+        const uint64_t bit = uint64_t(1) << (id & 63);
+        if (known_[id >> 6] & bit)
+            return (value_[id >> 6] & bit) != 0;
+        bool result = evaluate();
+        known_[id >> 6] |= bit;
+        value_[id >> 6] = result ? value_[id >> 6] | bit : value_[id >> 6] & ~bit;
+        return result;
+    }
+
+private:
+    std::vector<uint64_t> known_;   // Bit set: rule evaluated
+    std::vector<uint64_t> value_;   // Bit set: rule matched (valid if known)
+};
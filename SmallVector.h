@@ -0,0 +1,157 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+/*
+ * File: SmallVector.h
+ * -------------------
+ * Vector with inline storage for a few elements.
+ */
+
+/*
+ * Class: SmallVector
+ * ------------------
+ * Sequence of trivially copyable elements that keeps up to N of them
+ * inside the object and spills to the heap only beyond that. Short
+ * lists (most property and rule value lists hold 1-3 integers) cost no
+ * allocation, and their elements share a cache line with the object
+ * that owns them.
+ *
+ * Supports the subset of the std::vector interface the program uses.
+ * Like std::vector, growing invalidates pointers to the elements; moving
+ * a small vector that is stored inline copies its elements.
+ *
+ * Example:
+ *   SmallVector<int, 4> v{ 1, 2 };   // inline
+ *   v.push_back(3);
+ *   v.assign(big.begin(), big.end()); // heap once big.size() > 4
+ */
+template <class T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector holds trivially copyable types");
+    static_assert(N > 0, "SmallVector needs inline room for at least one element");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+    SmallVector(std::initializer_list<T> init) { assign(init.begin(), init.end()); }
+    template <class It>
+    SmallVector(It first, It last) { assign(first, last); }
+
+    SmallVector(const SmallVector& other) { assign(other.begin(), other.end()); }
+    SmallVector(SmallVector&& other) noexcept { take(other); }
+    ~SmallVector() { release(); }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            release();
+            take(other);
+        }
+        return *this;
+    }
+
+    // Size and storage
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+    bool isInline() const { return capacity_ == N; }
+
+    T* data() { return isInline() ? inline_ : heap_; }
+    const T* data() const { return isInline() ? inline_ : heap_; }
+    T* begin() { return data(); }
+    T* end() { return data() + size_; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size_; }
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+
+    // Modifiers
+    void clear() { size_ = 0; }
+
+    void reserve(size_t capacity) {
+        if (capacity <= capacity_) return;
+        T* heap = new T[capacity];
+        if (size_ > 0) std::memcpy(heap, data(), size_ * sizeof(T));
+        release();
+        heap_ = heap;
+        capacity_ = capacity;
+    }
+
+    void push_back(const T& value) {
+        if (size_ == capacity_) {
+            T copy = value;  // value may live in this vector
+            reserve(capacity_ * 2);
+            data()[size_++] = copy;
+        }
+        else {
+            data()[size_++] = value;
+        }
+    }
+
+    // New elements (when growing) are value-initialized
+    void resize(size_t size) {
+        reserve(size);
+        if (size > size_) std::fill(data() + size_, data() + size, T());
+        size_ = size;
+    }
+
+    template <class It>
+    void assign(It first, It last) {
+        size_ = 0;
+        reserve(static_cast<size_t>(std::distance(first, last)));
+        std::copy(first, last, data());
+        size_ = static_cast<size_t>(std::distance(first, last));
+    }
+
+    friend bool operator==(const SmallVector& a, const SmallVector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend bool operator!=(const SmallVector& a, const SmallVector& b) {
+        return !(a == b);
+    }
+
+private:
+    // Frees the heap buffer, if any, and returns to inline storage
+    void release() {
+        if (!isInline()) delete[] heap_;
+        capacity_ = N;
+    }
+
+    // Takes over the elements of other and leaves it empty and inline
+    void take(SmallVector& other) {
+        if (other.isInline()) {
+            std::memcpy(inline_, other.inline_, other.size_ * sizeof(T));
+        }
+        else {
+            heap_ = other.heap_;
+            capacity_ = other.capacity_;
+            other.capacity_ = N;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    union {
+        T inline_[N];    // Elements while size() <= N
+        T* heap_;        // Elements after spilling
+    };
+    size_t size_ = 0;
+    size_t capacity_ = N;
+};
+
+// Inline capacity of value lists (property values, EQUALS_EXACTLY lists)
+const size_t INLINE_INT_VALUES = 4;
+
+// List of integer values
+using IntList = SmallVector<int, INLINE_INT_VALUES>;
@@ -0,0 +1,175 @@
+/*
+ * File: StructuralIndex.cpp
+ * -------------------------
+ * Vectorized scan for the structural characters of record lines.
+ *
+ * Each 64-byte block of input is turned into a 64-bit mask with one bit
+ * per structural byte; the set bits are then converted into offsets.
+ * SSE2 and AVX2 kernels are selected at runtime, the scalar version
+ * handles the tail and non-x86 targets.
+ */
+
+#include "StructuralIndex.h"
+#include "CpuFeatures.h"
+
+#if FR_X86
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+ * Function: trailing_zeros
+ * ------------------------
+ * Index of the lowest set bit of a non-zero mask.
+ */
+static inline unsigned trailing_zeros(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, mask);
+    return (unsigned)idx;
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    if (_BitScanForward(&idx, (unsigned long)mask)) return (unsigned)idx;
+    _BitScanForward(&idx, (unsigned long)(mask >> 32));
+    return (unsigned)idx + 32;
+#else
+    return (unsigned)__builtin_ctzll(mask);
+#endif
+}
+
+/*
+ * Function: flush_mask
+ * --------------------
+ * Appends base + index of every set bit of mask to positions.
+ */
+static inline void flush_mask(uint64_t mask, uint32_t base, std::vector<uint32_t>& positions) {
+    while (mask != 0) {
+        positions.push_back(base + trailing_zeros(mask));
+        mask &= mask - 1;  // Clear the lowest set bit
+    }
+}
+
+/*
+ * Function: scan_scalar
+ * ---------------------
+ * Portable byte-by-byte scan of text[from, size).
+ */
+static void scan_scalar(const char* text, size_t from, size_t size, std::vector<uint32_t>& positions) {
+    for (size_t i = from; i < size; i++)
+        if (is_structural(text[i]))
+            positions.push_back((uint32_t)i);
+}
+
+#if FR_X86
+/*
+ * Function: structural_mask_sse2
+ * ------------------------------
+ * 16-bit mask of the structural bytes among 16 input bytes.
+ */
+static inline uint32_t structural_mask_sse2(const char* p) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i m = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')), _mm_cmpeq_epi8(v, _mm_set1_epi8('='))),
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('[')), _mm_cmpeq_epi8(v, _mm_set1_epi8(']'))));
+    m = _mm_or_si128(m,
+        _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(',')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+    return (uint32_t)_mm_movemask_epi8(m);
+}
+
+/*
+ * Function: scan_sse2
+ * -------------------
+ * Classifies 64 bytes per step, four vectors of 16 bytes, with six
+ * compares per vector (one each for : = [ ] , and newline).
+ */
+static void scan_sse2(const char* text, size_t size, std::vector<uint32_t>& positions) {
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        uint64_t mask = (uint64_t)structural_mask_sse2(text + i)
+            | ((uint64_t)structural_mask_sse2(text + i + 16) << 16)
+            | ((uint64_t)structural_mask_sse2(text + i + 32) << 32)
+            | ((uint64_t)structural_mask_sse2(text + i + 48) << 48);
+        flush_mask(mask, (uint32_t)i, positions);
+    }
+    scan_scalar(text, i, size, positions);
+}
+
+/*
+ * Function: structural_mask_avx2
+ * ------------------------------
+ * 32-bit mask of the structural bytes among 32 input bytes.
+ */
+FR_TARGET_AVX2
+static inline uint32_t structural_mask_avx2(const char* p) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i m = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('='))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('[')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(']'))));
+    m = _mm256_or_si256(m,
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(',')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+    return (uint32_t)_mm256_movemask_epi8(m);
+}
+
+/*
+ * Function: scan_avx2
+ * -------------------
+ * Classifies 64 bytes per step, two vectors of 32 bytes, with six
+ * compares per vector (one each for : = [ ] , and newline).
+ */
+FR_TARGET_AVX2
+static void scan_avx2(const char* text, size_t size, std::vector<uint32_t>& positions) {
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        uint64_t mask = (uint64_t)structural_mask_avx2(text + i)
+            | ((uint64_t)structural_mask_avx2(text + i + 32) << 32);
+        flush_mask(mask, (uint32_t)i, positions);
+    }
+    scan_scalar(text, i, size, positions);
+}
+#endif
+
+/*
+ * Function: resolve_scanner
+ * -------------------------
+ * Maps a requested scanner to one the CPU supports.
+ */
+static StructuralScanner resolve_scanner(StructuralScanner requested) {
+    const CpuFeatures& cpu = cpu_features();
+    if (requested == StructuralScanner::AUTO || requested == StructuralScanner::AVX2) {
+        if (cpu.avx2) return StructuralScanner::AVX2;
+        requested = StructuralScanner::SSE2;
+    }
+    if (requested == StructuralScanner::SSE2 && cpu.sse2)
+        return StructuralScanner::SSE2;
+    return StructuralScanner::SCALAR;
+}
+
+void find_structurals(std::string_view text, std::vector<uint32_t>& positions,
+    StructuralScanner scanner) {
+    static const StructuralScanner best = resolve_scanner(StructuralScanner::AUTO);
+    scanner = (scanner == StructuralScanner::AUTO) ? best : resolve_scanner(scanner);
+
+    switch (scanner) {
+#if FR_X86
+    case StructuralScanner::AVX2:
+        scan_avx2(text.data(), text.size(), positions);
+        break;
+    case StructuralScanner::SSE2:
+        scan_sse2(text.data(), text.size(), positions);
+        break;
+#endif
+    default:
+        scan_scalar(text.data(), 0, text.size(), positions);
+        break;
+    }
+}
+
+const char* structural_scanner_name() {
+    switch (resolve_scanner(StructuralScanner::AUTO)) {
+    case StructuralScanner::AVX2: return "avx2";
+    case StructuralScanner::SSE2: return "sse2";
+    default:                      return "scalar";
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/*
+ * Enum: StructuralScanner
+ * -----------------------
+ * Implementations of the structural character scan.
+ *
+ * Possible values:
+ *   - AUTO   : best implementation supported by the running CPU.
+ *   - SCALAR : byte-by-byte table lookup (portable fallback).
+ *   - SSE2   : 16-byte compares, 64 bytes per step.
+ *   - AVX2   : 32-byte compares, 64 bytes per step.
+ */
+enum class StructuralScanner {
+    AUTO,
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+/*
+ * Function: is_structural
+ * -----------------------
+ * Returns true for the characters that drive the record grammar
+ * "Name: prop = [v, v], prop = [v]": ':', '=', '[', ']', ',' and '\n'.
+ */
+inline bool is_structural(char c) {
+    return c == ':' || c == '=' || c == '[' || c == ']' || c == ',' || c == '\n';
+}
+
+/*
+ * Function: find_structurals
+ * --------------------------
+ * Appends the offsets of all structural characters of text to positions,
+ * in increasing order. The text is classified 64 bytes at a time into a
+ * bitmask of structural positions using the widest SIMD instruction set
+ * available, so the parser only visits interesting bytes.
+ *
+ * Parameters:
+ *   - text      : input to scan (must be shorter than 4 GiB).
+ *   - positions : receives offsets relative to text.data().
+ *   - scanner   : implementation to use; unsupported choices fall back
+ *                 to the best supported one.
+ */
+void find_structurals(std::string_view text, std::vector<uint32_t>& positions,
+    StructuralScanner scanner = StructuralScanner::AUTO);
+
+/*
+ * Function: structural_scanner_name
+ * ---------------------------------
+ * Name of the implementation AUTO resolves to on this CPU
+ * ("avx2", "sse2" or "scalar").
+ */
+const char* structural_scanner_name();
@@ -0,0 +1,147 @@
+/*
+ * File: ThreadPool.cpp
+ * --------------------
+ * Work-stealing parallel loops.
+ */
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+/*
+ * Constructor: ThreadPool
+ * -----------------------
+ * The calling thread is thread 0 of every loop; workers are 1 .. n - 1.
+ */
+ThreadPool::ThreadPool(unsigned threads)
+    : ranges_(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads) {
+    for (size_t i = 1; i < ranges_.size(); i++)
+        workers_.emplace_back(&ThreadPool::work, this, i);
+}
+
+/*
+ * Destructor: ~ThreadPool
+ * -----------------------
+ * Wakes the idle workers to let them exit, and joins them.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& w : workers_)
+        w.join();
+}
+
+/*
+ * Method: parallelFor
+ * -------------------
+ * Deals the iterations out in equal contiguous ranges, starts the
+ * workers and runs the caller's own range; stealing evens out the rest.
+ */
+void ThreadPool::parallelFor(size_t count, const Task& task) {
+    if (workers_.empty() || count <= 1) {
+        for (size_t i = 0; i < count; i++)
+            task(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        const size_t n = ranges_.size();
+        for (size_t t = 0; t < n; t++) {
+            std::lock_guard<std::mutex> rangeGuard(ranges_[t].lock);
+            ranges_[t].begin = count * t / n;
+            ranges_[t].end = count * (t + 1) / n;
+        }
+        task_ = &task;
+        running_ = workers_.size();
+        generation_++;
+    }
+    wake_.notify_all();
+
+    runLoop(0);
+
+    std::unique_lock<std::mutex> guard(mutex_);
+    done_.wait(guard, [this] { return running_ == 0; });
+    task_ = nullptr;
+}
+
+/*
+ * Method: work
+ * ------------
+ * Body of a worker: waits for a new loop (or the end of the pool),
+ * takes part in it, and reports back.
+ */
+void ThreadPool::work(size_t self) {
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guard(mutex_);
+            wake_.wait(guard, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+
+        runLoop(self);
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (--running_ == 0)
+            done_.notify_one();
+    }
+}
+
+/*
+ * Method: runLoop
+ * ---------------
+ * Runs iterations until none is left anywhere.
+ */
+void ThreadPool::runLoop(size_t self) {
+    size_t index;
+    while (next(self, index))
+        (*task_)(index, self);
+}
+
+/*
+ * Method: next
+ * ------------
+ * Takes the next iteration of the thread's own range; if it is empty,
+ * steals the back half of the first other range that is not. At most
+ * one range lock is held at a time, and only the owner ever grows a
+ * range, so no iteration is lost or run twice.
+ *
+ * Returns:
+ *   true  with the iteration in index,
+ *   false if all ranges are empty.
+ */
+bool ThreadPool::next(size_t self, size_t& index) {
+    {
+        Range& own = ranges_[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (own.begin < own.end) {
+            index = own.begin++;
+            return true;
+        }
+    }
+
+    const size_t n = ranges_.size();
+    for (size_t k = 1; k < n; k++) {
+        Range& victim = ranges_[(self + k) % n];
+        size_t first, last;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.begin >= victim.end) continue;
+            last = victim.end;
+            first = victim.begin + (victim.end - victim.begin) / 2;
+            victim.end = first;
+        }
+
+        Range& own = ranges_[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        own.begin = first + 1;
+        own.end = last;
+        index = first;
+        return true;
+    }
+    return false;
+}
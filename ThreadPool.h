@@ -0,0 +1,79 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * File: ThreadPool.h
+ * ------------------
+ * Fixed set of worker threads running parallel loops with work stealing.
+ */
+
+// Most threads a pool (or the parser) is asked to run; --threads is
+// limited to this
+const unsigned MAX_THREADS = 256;
+
+/*
+ * Class: ThreadPool
+ * -----------------
+ * Runs the iterations of a loop on a fixed set of threads (the workers
+ * and the calling thread). Each thread starts with an equal, contiguous
+ * range of the iterations and takes them from the front; a thread that
+ * runs out steals the back half of another thread's remaining range, so
+ * uneven iterations still keep every thread busy until the loop ends.
+ *
+ * Iterations must not throw. Which thread runs an iteration is not
+ * deterministic; callers that need ordered results write them by
+ * iteration index and merge afterwards.
+ *
+ * Example:
+ *   ThreadPool pool(4);
+ *   std::vector<int> squares(100);
+ *   pool.parallelFor(100, [&](size_t i, size_t thread) { squares[i] = int(i * i); });
+ */
+class ThreadPool {
+public:
+    // Body of a loop: (iteration index, index of the running thread)
+    using Task = std::function<void(size_t, size_t)>;
+
+    // Starts threads - 1 workers (0 = hardware concurrency)
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of threads running a loop, including the caller; thread
+    // indices passed to tasks are below this
+    size_t size() const { return ranges_.size(); }
+
+    // Runs task(i, thread) for every i in [0, count) and returns when
+    // all iterations are done
+    void parallelFor(size_t count, const Task& task);
+
+private:
+    // Iterations [begin, end) not yet started by one thread
+    struct Range {
+        std::mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    void work(size_t self);
+    void runLoop(size_t self);
+    bool next(size_t self, size_t& index);
+
+    std::vector<Range> ranges_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;   // A loop started, or the pool stops
+    std::condition_variable done_;   // A worker finished its part of a loop
+    const Task* task_ = nullptr;
+    size_t generation_ = 0;          // Number of loops started
+    size_t running_ = 0;             // Workers still in the current loop
+    bool stop_ = false;
+};
@@ -1,7 +1,4 @@
 ﻿#include "Validation.h"
-#include <set>
-#include <algorithm>  // for transform
-#include <cctype>     // for tolower
 
 /*
  * Function: validate_records
@@ -12,7 +9,9 @@
  *   - At least one record must exist.
  *   - Record name must not be empty.
  *   - Each record must have at least one property.
- *   - No duplicate property names (case-insensitive) are allowed within the same record.
+ *
+ * Duplicate property names (case-insensitive) cannot occur: properties are
+ * keyed by the id of their case-folded name.
  *
  * Returns:
  *   DataCheckResult with isCorrect = true if valid,
@@ -20,8 +19,9 @@
  */
 DataCheckResult validate_records(const std::vector<Record>& records) {
     //  No records found
-    if (records.empty())
-        return { false, "No records found in input file" };
+    DataCheckResult countCheck = validate_record_count(records.size());
+    if (!countCheck.isCorrect)
+        return countCheck;
 
     for (const auto& rec : records) {
         //  Record name must not be empty
@@ -31,22 +31,27 @@ DataCheckResult validate_records(const std::vector<Record>& records) {
         //  Record must have at least one property
         if (rec.properties.empty())
             return { false, "No properties defined for record" };
-
-        //  Check for duplicate property names (case-insensitive)
-        std::set<std::string> seen;
-        for (const auto& kv : rec.properties) {
-            std::string lowerKey = kv.first;
-            std::transform(lowerKey.begin(), lowerKey.end(), lowerKey.begin(),
-                [](unsigned char c) { return std::tolower(c); });
-
-            if (!seen.insert(lowerKey).second)
-                return { false, "Duplicate property name detected" };
-        }
     }
 
     return { true, "" }; //  Valid records
 }
 
+/*
+ * Function: validate_record_count
+ * -------------------------------
+ * Checks that at least one record was read. Used on its own when records
+ * are classified while streaming and are not kept for validate_records.
+ *
+ * Returns:
+ *   DataCheckResult with isCorrect = true if count > 0,
+ *   otherwise false with the corresponding error reason.
+ */
+DataCheckResult validate_record_count(size_t count) {
+    if (count == 0)
+        return { false, "No records found in input file" };
+    return { true, "" };
+}
+
 /*
  * Function: validate_classes
  * --------------------------
@@ -5,4 +5,5 @@
 #include "DataCheckResult.h"
 
 DataCheckResult validate_records(const std::vector<Record>& records);
+DataCheckResult validate_record_count(size_t count);
 DataCheckResult validate_classes(const std::vector<ClassRule>& classes);
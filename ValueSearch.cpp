@@ -0,0 +1,218 @@
+/*
+ * File: ValueSearch.cpp
+ * ---------------------
+ * Value list kernels with runtime CPU dispatch.
+ *
+ * Every kernel handles whole vectors and leaves the remaining values to
+ * the scalar loop (AVX-512 to one masked compare); AUTO is resolved once
+ * and then costs one indirect call.
+ */
+
+#include "ValueSearch.h"
+#include "CpuFeatures.h"
+
+#if FR_X86
+#include <immintrin.h>
+#endif
+
+using ContainsKernel = bool (*)(const int*, size_t, int);
+using EqualKernel = bool (*)(const int*, const int*, size_t);
+
+/*
+ * Function: contains_scalar
+ * -------------------------
+ * Portable search of values[0, count).
+ */
+static bool contains_scalar(const int* values, size_t count, int value) {
+    for (size_t i = 0; i < count; i++)
+        if (values[i] == value) return true;
+    return false;
+}
+
+/*
+ * Function: equal_scalar
+ * ----------------------
+ * Portable comparison, one value at a time.
+ */
+static bool equal_scalar(const int* a, const int* b, size_t count) {
+    for (size_t i = 0; i < count; i++)
+        if (a[i] != b[i]) return false;
+    return true;
+}
+
+#if FR_X86
+/*
+ * Function: contains_sse2
+ * -----------------------
+ * Compares 16 values per step (four vectors ORed before one movemask).
+ */
+static bool contains_sse2(const int* values, size_t count, int value) {
+    const __m128i needle = _mm_set1_epi32(value);
+    auto at = [values](size_t i) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)); };
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i m = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(at(i), needle), _mm_cmpeq_epi32(at(i + 4), needle)),
+            _mm_or_si128(_mm_cmpeq_epi32(at(i + 8), needle), _mm_cmpeq_epi32(at(i + 12), needle)));
+        if (_mm_movemask_epi8(m) != 0) return true;
+    }
+    for (; i + 4 <= count; i += 4)
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(at(i), needle)) != 0) return true;
+    return contains_scalar(values + i, count - i, value);
+}
+
+/*
+ * Function: equal_sse2
+ * --------------------
+ * Compares 4 values per step; any differing lane clears a mask bit.
+ */
+static bool equal_sse2(const int* a, const int* b, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(x, y)) != 0xFFFF) return false;
+    }
+    return equal_scalar(a + i, b + i, count - i);
+}
+
+/*
+ * Function: contains_avx2
+ * -----------------------
+ * Compares 32 values per step (four vectors ORed before one movemask).
+ */
+FR_TARGET_AVX2
+static bool contains_avx2(const int* values, size_t count, int value) {
+    const __m256i needle = _mm256_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(values + i);
+        __m256i m = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256(p), needle),
+                _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 1), needle)),
+            _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256(p + 2), needle),
+                _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 3), needle)));
+        if (_mm256_movemask_epi8(m) != 0) return true;
+    }
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(v, needle)) != 0) return true;
+    }
+    return contains_scalar(values + i, count - i, value);
+}
+
+/*
+ * Function: equal_avx2
+ * --------------------
+ * Compares 8 values per step.
+ */
+FR_TARGET_AVX2
+static bool equal_avx2(const int* a, const int* b, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(x, y)) != -1) return false;
+    }
+    return equal_scalar(a + i, b + i, count - i);
+}
+
+/*
+ * Function: contains_avx512
+ * -------------------------
+ * Compares 16 values per step straight into a mask register; the tail
+ * is a masked load, so no scalar loop is left.
+ */
+FR_TARGET_AVX512
+static bool contains_avx512(const int* values, size_t count, int value) {
+    const __m512i needle = _mm512_set1_epi32(value);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+        if (_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(values + i), needle) != 0) return true;
+    if (i == count) return false;
+    const __mmask16 tail = static_cast<__mmask16>((1u << (count - i)) - 1);
+    return _mm512_mask_cmpeq_epi32_mask(tail, _mm512_maskz_loadu_epi32(tail, values + i), needle) != 0;
+}
+
+/*
+ * Function: equal_avx512
+ * ----------------------
+ * Compares 16 values per step, the tail with a masked load.
+ */
+FR_TARGET_AVX512
+static bool equal_avx512(const int* a, const int* b, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+        if (_mm512_cmpneq_epi32_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)) != 0) return false;
+    if (i == count) return true;
+    const __mmask16 tail = static_cast<__mmask16>((1u << (count - i)) - 1);
+    return _mm512_mask_cmpneq_epi32_mask(tail, _mm512_maskz_loadu_epi32(tail, a + i),
+        _mm512_maskz_loadu_epi32(tail, b + i)) == 0;
+}
+#endif
+
+/*
+ * Function: resolve_kernel
+ * ------------------------
+ * Maps a requested kernel to one the CPU supports.
+ */
+static ValueKernel resolve_kernel(ValueKernel requested) {
+    const CpuFeatures& cpu = cpu_features();
+    if (requested == ValueKernel::AUTO || requested == ValueKernel::AVX512) {
+        if (cpu.avx512) return ValueKernel::AVX512;
+        requested = ValueKernel::AVX2;
+    }
+    if (requested == ValueKernel::AVX2) {
+        if (cpu.avx2) return ValueKernel::AVX2;
+        requested = ValueKernel::SSE2;
+    }
+    if (requested == ValueKernel::SSE2 && cpu.sse2)
+        return ValueKernel::SSE2;
+    return ValueKernel::SCALAR;
+}
+
+/*
+ * Function: contains_kernel, equal_kernel
+ * ---------------------------------------
+ * Kernel functions of a supported kernel.
+ */
+static ContainsKernel contains_kernel(ValueKernel kernel) {
+    switch (resolve_kernel(kernel)) {
+#if FR_X86
+    case ValueKernel::AVX512: return contains_avx512;
+    case ValueKernel::AVX2:   return contains_avx2;
+    case ValueKernel::SSE2:   return contains_sse2;
+#endif
+    default:                  return contains_scalar;
+    }
+}
+
+static EqualKernel equal_kernel(ValueKernel kernel) {
+    switch (resolve_kernel(kernel)) {
+#if FR_X86
+    case ValueKernel::AVX512: return equal_avx512;
+    case ValueKernel::AVX2:   return equal_avx2;
+    case ValueKernel::SSE2:   return equal_sse2;
+#endif
+    default:                  return equal_scalar;
+    }
+}
+
+bool contains_value(const int* values, size_t count, int value, ValueKernel kernel) {
+    static const ContainsKernel best = contains_kernel(ValueKernel::AUTO);
+    return (kernel == ValueKernel::AUTO ? best : contains_kernel(kernel))(values, count, value);
+}
+
+bool equal_values(const int* a, const int* b, size_t count, ValueKernel kernel) {
+    static const EqualKernel best = equal_kernel(ValueKernel::AUTO);
+    return (kernel == ValueKernel::AUTO ? best : equal_kernel(kernel))(a, b, count);
+}
+
+const char* value_kernel_name() {
+    switch (resolve_kernel(ValueKernel::AUTO)) {
+    case ValueKernel::AVX512: return "avx512";
+    case ValueKernel::AVX2:   return "avx2";
+    case ValueKernel::SSE2:   return "sse2";
+    default:                  return "scalar";
+    }
+}
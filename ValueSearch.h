@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+
+/*
+ * File: ValueSearch.h
+ * -------------------
+ * Vectorized search and comparison of int value lists, the inner loops
+ * of CONTAINS_VALUE and EQUALS_EXACTLY.
+ */
+
+/*
+ * Enum: ValueKernel
+ * -----------------
+ * Implementations of the value list kernels.
+ *
+ * Possible values:
+ *   - AUTO   : best implementation supported by the running CPU.
+ *   - SCALAR : one value at a time (portable fallback).
+ *   - SSE2   : 4 values per compare.
+ *   - AVX2   : 8 values per compare.
+ *   - AVX512 : 16 values per compare.
+ */
+enum class ValueKernel {
+    AUTO,
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+// Lists shorter than this are always searched by the scalar loop: most
+// properties have a handful of values, and for those the dispatch costs
+// more than the vector compares save
+const size_t SIMD_MIN_VALUES = 8;
+
+/*
+ * Function: contains_value
+ * ------------------------
+ * True if one of values[0 .. count) equals value. Broadcasts value and
+ * compares a vector of the list at a time; a kernel the CPU does not
+ * support falls back to the best one it does.
+ */
+bool contains_value(const int* values, size_t count, int value, ValueKernel kernel);
+
+inline bool contains_value(const int* values, size_t count, int value) {
+    if (count >= SIMD_MIN_VALUES)
+        return contains_value(values, count, value, ValueKernel::AUTO);
+    for (size_t i = 0; i < count; i++)
+        if (values[i] == value) return true;
+    return false;
+}
+
+/*
+ * Function: equal_values
+ * ----------------------
+ * True if a[0 .. count) and b[0 .. count) are equal, compared a vector
+ * at a time. Lists of different lengths are the caller's business.
+ */
+bool equal_values(const int* a, const int* b, size_t count, ValueKernel kernel);
+
+inline bool equal_values(const int* a, const int* b, size_t count) {
+    if (count >= SIMD_MIN_VALUES)
+        return equal_values(a, b, count, ValueKernel::AUTO);
+    for (size_t i = 0; i < count; i++)
+        if (a[i] != b[i]) return false;
+    return true;
+}
+
+/*
+ * Function: value_kernel_name
+ * ---------------------------
+ * Name of the implementation AUTO resolves to on this CPU
+ * ("avx512", "avx2", "sse2" or "scalar").
+ */
+const char* value_kernel_name();
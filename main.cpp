@@ -12,14 +12,29 @@
 
 #include <iostream>
 #include <fstream>
+#include <cctype>
+#include <cstring>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <map>
+#include <iterator>
+#include <charconv>
 #include "Record.h"
 #include "Rule.h"
 #include "Parser.h"
 #include "Classifier.h"
 #include "Validation.h"
 #include "Error.h"
+#include "InputFile.h"
+#include "ErrorSink.h"
+#include "RecordSnapshot.h"
+#include "RecordStore.h"
+#include "InvertedIndex.h"
+#include "RuleCache.h"
+#include "RuleStats.h"
+#include "CpuFeatures.h"
+#include "IncrementalParser.h"
 #include <set>
 using namespace std;
 
@@ -35,45 +50,226 @@ using namespace std;
 // ============================================================================
 
 /**
- * @brief Validates command line arguments
+ * @brief Command line settings of one run
+ */
+struct ProgramOptions {
+    string itemsFile;                  // Path to the items file
+    string rulesFile;                  // Path to the rules file
+    string outputFile = "output.txt";  // Path to the output file
+    unsigned threads = 0;              // Worker threads (0 = hardware concurrency)
+    bool stream = false;               // Classify records while parsing them
+    bool packValues = false;           // Bit-pack the values of the record store
+    string engine = "bitmap";          // Classification engine (scan, index, bitmap);
+                                       // bitmap: the index it needs covers only the
+                                       // rule properties, and it is never far behind
+                                       // scan while many classes make scan slow
+    ClassifyTiling tiling;             // Block sizes of the scan engine (0 = auto)
+    string compileItems;               // Snapshot to write instead of classifying
+    string rulesCache;                 // Compiled ruleset cache (empty = none)
+    string ruleStats;                  // Rule pass rate statistics (empty = none)
+    string incremental;                // Per-line sidecar of the items file (empty = none)
+    size_t errorExamples = DEFAULT_ERROR_EXAMPLES;  // Locations shown per error code
+};
+
+/**
+ * @brief Reads a decimal number that must fill text up to end
+ * @param text Argument text
+ * @param end End of the number within text (nullptr = end of text)
+ * @param value Receives the number
+ * @return true if text[0 .. end) is a number without sign that fits
+ *
+ * Complexity: CCN = 3, NLOC = 6
+ */
+bool parseNumber(const char* text, const char* end, size_t& value) {
+    if (end == nullptr) end = text + char_traits<char>::length(text);
+    if (text == end || !isdigit((unsigned char)*text)) return false;
+    auto parsed = from_chars(text, end, value);
+    return parsed.ec == errc() && parsed.ptr == end;
+}
+
+/**
+ * @brief Parses and validates command line arguments
  * @param argc Number of command line arguments
  * @param argv Array of command line argument strings
+ * @param options Receives the parsed settings
  * @return true if arguments are valid, false otherwise
  *
- * Complexity: CCN = 2, NLOC = 8
+ * Positional arguments are <items_file> <rules_file> [output_file];
+ * options may appear anywhere:
+ *   --threads N   number of worker threads used for parsing and by
+ *                 every classification engine
+ *   --stream      classify each record as it is parsed instead of
+ *                 keeping all records in memory
+ *   --pack-values keep record values bit-packed while classifying
+ *                 (less memory, no specialized value layouts)
+ *   --engine NAME how records of the store are classified: "scan"
+ *                 (every record against every class, each distinct
+ *                 rule once per record), "index"
+ *                 (posting list intersection) or "bitmap" (shared
+ *                 per-rule bitmaps, the default)
+ *   --tile RxC    block sizes of the scan engine: R records by C classes
+ *                 (0 = sized to the L2 cache, the default)
+ *   --compile-items FILE
+ *                 write the parsed items as a binary snapshot to FILE
+ *                 and exit; only <items_file> is required
+ *   --rules-cache FILE
+ *                 load the rules from the compiled cache FILE when it was
+ *                 built from the same rules text, otherwise parse them
+ *                 and rebuild FILE
+ *   --rule-stats FILE
+ *                 order each class's rules using the pass rates kept in
+ *                 FILE by earlier runs, and update FILE (scan engine
+ *                 or --stream only)
+ *   --incremental FILE
+ *                 reparse only the items lines that changed since the
+ *                 run that wrote the sidecar FILE (in parallel, with
+ *                 --threads), then rewrite FILE if any line changed
+ *                 (not with --stream); hashing every line and writing
+ *                 FILE cost about as much as the parse saves, so an
+ *                 unchanged file takes about as long as a full parse
+ *                 and a changed one longer
+ *   --error-examples N
+ *                 number of locations listed per error code
+ *
+ * Complexity: CCN = 35, NLOC = 104
  */
-bool validateCommandLineArgs(int argc, char* argv[]) {
-    if (argc < 3) {
+bool parseCommandLineArgs(int argc, char* argv[], ProgramOptions& options) {
+    vector<string> positional;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--threads") {
+            size_t threads = 0;
+            if (i + 1 >= argc || !parseNumber(argv[i + 1], nullptr, threads)) {
+                cerr << RED << "[ERROR] --threads expects a number." << RESET << endl;
+                return false;
+            }
+            if (threads > MAX_THREADS) {
+                cerr << YELLOW << "[WARN] --threads " << threads << " is limited to " << MAX_THREADS << "." << RESET << endl;
+                threads = MAX_THREADS;
+            }
+            options.threads = (unsigned)threads;
+            i++;
+        }
+        else if (arg == "--stream") {
+            options.stream = true;
+        }
+        else if (arg == "--pack-values") {
+            options.packValues = true;
+        }
+        else if (arg == "--engine") {
+            if (i + 1 >= argc || (string(argv[i + 1]) != "scan" && string(argv[i + 1]) != "index"
+                && string(argv[i + 1]) != "bitmap")) {
+                cerr << RED << "[ERROR] --engine expects scan, index or bitmap." << RESET << endl;
+                return false;
+            }
+            options.engine = argv[++i];
+        }
+        else if (arg == "--tile") {
+            const char* x = i + 1 < argc ? strchr(argv[i + 1], 'x') : nullptr;
+            if (x == nullptr || !parseNumber(argv[i + 1], x, options.tiling.records) ||
+                !parseNumber(x + 1, nullptr, options.tiling.classes)) {
+                cerr << RED << "[ERROR] --tile expects RECORDSxCLASSES, e.g. 1024x64." << RESET << endl;
+                return false;
+            }
+            i++;
+        }
+        else if (arg == "--compile-items") {
+            if (i + 1 >= argc) {
+                cerr << RED << "[ERROR] --compile-items expects a file name." << RESET << endl;
+                return false;
+            }
+            options.compileItems = argv[++i];
+        }
+        else if (arg == "--rules-cache") {
+            if (i + 1 >= argc) {
+                cerr << RED << "[ERROR] --rules-cache expects a file name." << RESET << endl;
+                return false;
+            }
+            options.rulesCache = argv[++i];
+        }
+        else if (arg == "--rule-stats") {
+            if (i + 1 >= argc) {
+                cerr << RED << "[ERROR] --rule-stats expects a file name." << RESET << endl;
+                return false;
+            }
+            options.ruleStats = argv[++i];
+        }
+        else if (arg == "--error-examples") {
+            if (i + 1 >= argc || !parseNumber(argv[i + 1], nullptr, options.errorExamples)) {
+                cerr << RED << "[ERROR] --error-examples expects a number." << RESET << endl;
+                return false;
+            }
+            if (options.errorExamples > MAX_ERROR_EXAMPLES) {
+                cerr << YELLOW << "[WARN] --error-examples " << options.errorExamples << " is limited to "
+                    << MAX_ERROR_EXAMPLES << "." << RESET << endl;
+                options.errorExamples = MAX_ERROR_EXAMPLES;
+            }
+            i++;
+        }
+        else if (arg == "--incremental") {
+            if (i + 1 >= argc) {
+                cerr << RED << "[ERROR] --incremental expects a file name." << RESET << endl;
+                return false;
+            }
+            options.incremental = argv[++i];
+        }
+        else {
+            positional.push_back(arg);
+        }
+    }
+
+    // Streamed records are not kept, so there is nothing to reuse
+    if (!options.incremental.empty() && options.stream) {
+        cerr << RED << "[ERROR] --incremental cannot be combined with --stream." << RESET << endl;
+        return false;
+    }
+
+    // Only the scan engine and streaming evaluate rules in a chosen order
+    if (!options.ruleStats.empty() && !options.stream && options.engine != "scan") {
+        cerr << RED << "[ERROR] --rule-stats needs --engine scan or --stream." << RESET << endl;
+        return false;
+    }
+
+    size_t required = options.compileItems.empty() ? 2 : 1;
+    if (positional.size() < required) {
         cerr << RED << "[ERROR] Not enough arguments.\n"
-            << "Usage: FilteringRecords.exe <items_file> <rules_file> [output_file]\n"
+            << "Usage: FilteringRecords.exe <items_file> <rules_file> [output_file] [--threads N] [--stream]\n"
+            << "                            [--pack-values] [--engine NAME] [--tile RxC] [--rules-cache FILE] [--rule-stats FILE]\n"
+            << "                            [--incremental FILE] [--error-examples N]\n"
+            << "       FilteringRecords.exe <items_file> --compile-items <snapshot_file>\n"
             << "Use -h for help." << RESET << endl;
         return false;
     }
+
+    options.itemsFile = positional[0];
+    if (positional.size() >= 2) options.rulesFile = positional[1];
+    if (positional.size() >= 3) options.outputFile = positional[2];
     return true;
 }
 
 /**
  * @brief Opens and validates input files
- * @param itemsFile Path to the items input file
- * @param rulesFile Path to the rules input file
- * @param items Reference to items ifstream object
- * @param rules Reference to rules ifstream object
+ * @param itemsFile Path to the items input file ("-" for standard input)
+ * @param rulesFile Path to the rules input file ("-" for standard input)
+ * @param items Reference to the items input file
+ * @param rules Reference to the rules input file
  * @return true if both files opened successfully, false otherwise
  *
+ * Regular files are memory-mapped so that the parsers can walk their
+ * lines in place; pipes and standard input are read into memory.
+ *
  * Complexity: CCN = 3, NLOC = 17
  */
 bool openInputFiles(const string& itemsFile, const string& rulesFile,
-    ifstream& items, ifstream& rules) {
+    InputFile& items, InputFile& rules) {
     // Open items file
-    items.open(itemsFile);
-    if (!items) {
+    if (!items.open(itemsFile)) {
         cerr << RED << "[ERROR] Cannot open file: " << itemsFile << RESET << endl;
         return false;
     }
 
     // Open rules file
-    rules.open(rulesFile);
-    if (!rules) {
+    if (!rules.open(rulesFile)) {
         cerr << RED << "[ERROR] Cannot open file: " << rulesFile << RESET << endl;
         return false;
     }
@@ -85,102 +281,245 @@ bool openInputFiles(const string& itemsFile, const string& rulesFile,
 }
 
 /**
- * @brief Parses records from input stream
- * @param items Input file stream containing record definitions
+ * @brief Parses records from the items file contents
+ * @param items Contents of the items file
  * @param records Vector to store successfully parsed records
- * @param errors Set to collect parsing errors
+ * @param errors Sink collecting parsing errors
+ * @param threads Number of parser threads (0 = hardware concurrency)
+ * @param arena Memory for the records; must outlive them
+ *
+ * Lines are views into the input buffer and are parsed in parallel
+ * chunks; records and warnings keep the order of the input file.
+ *
+ * Complexity: CCN = 2, NLOC = 6
+ */
+void parseRecords(string_view items, vector<Record>& records, ErrorSink& errors, unsigned threads,
+    RecordArena& arena) {
+    vector<string_view> rejected;
+    parse_records(items, records, errors, rejected, threads, &arena);
+
+    // Report invalid lines; processing of the remaining records continued
+    for (string_view clean : rejected)
+        cerr << YELLOW << "[WARN] Invalid record format: " << clean << RESET << endl;
+}
+
+/**
+ * @brief Parses records, reusing the unchanged lines of the previous run
+ * @param items Contents of the items file
+ * @param records Vector to store successfully parsed records
+ * @param errors Sink collecting parsing errors
+ * @param sidecarFile Per-line sidecar written by the previous run
+ * @param threads Number of parser threads (0 = hardware concurrency)
+ * @param arena Memory for the records; must outlive them
+ *
+ * Lines whose content hash is found in the sidecar are not parsed again;
+ * the others are parsed in parallel chunks, as by parseRecords(). The
+ * sidecar is then rewritten for the next run unless no line changed. A
+ * missing or outdated sidecar only means that every line is parsed. The
+ * result is identical to parseRecords().
  *
  * Complexity: CCN = 4, NLOC = 18
  */
-void parseRecords(ifstream& items, vector<Record>& records, set<Error>& errors) {
-    string line;
-    while (getline(items, line)) {
-        // Skip empty lines
-        string clean = trim(line);
-        if (clean.empty()) continue;
-
-        // Attempt to parse the record
-        Record r;
-        if (!parse_record_line(clean, r, errors)) {
-            cerr << YELLOW << "[WARN] Invalid record format: " << clean << RESET << endl;
-            continue; // Continue processing remaining records
-        }
-        records.push_back(r);
+void parseRecordsIncremental(string_view items, vector<Record>& records, ErrorSink& errors,
+    const string& sidecarFile, unsigned threads, RecordArena& arena) {
+    IncrementalParser parser;
+    vector<string_view> rejected;
+    {
+        // The previous sidecar is only read while parsing
+        InputFile sidecar;
+        if (sidecar.open(sidecarFile)) parser.load(sidecar.data());
+        parser.parse(items, records, errors, rejected, threads, &arena);
     }
+
+    for (string_view clean : rejected)
+        cerr << YELLOW << "[WARN] Invalid record format: " << clean << RESET << endl;
+    cout << YELLOW << "[INFO] Incremental parse: " << parser.reusedLines() << " line(s) reused, "
+        << parser.parsedLines() << " parsed" << RESET << endl;
+
+    if (!parser.upToDate() && !parser.write(sidecarFile, records))
+        cerr << YELLOW << "[WARN] Cannot write sidecar: " << sidecarFile << RESET << endl;
 }
 
 /**
- * @brief Parses classification rules from input stream
- * @param rules Input file stream containing rule definitions
- * @param classes Vector to store successfully parsed class rules
- * @param errors Set to collect parsing errors
+ * @brief Orders the rules of each class by cost and selectivity
+ * @param table Rule table to reorder
+ * @param store Records to sample pass rates from (nullptr = none)
+ * @param statsFile Statistics kept between runs ("" = none)
  *
- * Complexity: CCN = 4, NLOC = 18
+ * Pass rates measured on a sample of the store are added to those of
+ * the stats file, if it exists, and the file is rewritten with the
+ * sum. The order never changes which records match a class.
+ *
+ * Complexity: CCN = 6, NLOC = 14
  */
-void parseRules(ifstream& rules, vector<ClassRule>& classes, set<Error>& errors) {
-    string line;
-    while (getline(rules, line)) {
-        // Skip empty lines
-        string clean = trim(line);
-        if (clean.empty()) continue;
-
-        // Attempt to parse the class rule
-        ClassRule cr;
-        if (!parse_class_line(clean, cr, errors)) {
-            cerr << YELLOW << "[WARN] Invalid rule format: " << clean << RESET << endl;
-            continue; // Continue processing remaining rules
-        }
+void orderRules(RuleTable& table, const RecordStore* store, const string& statsFile) {
+    RuleStats stats(table);
+    if (!statsFile.empty()) {
+        InputFile file;
+        if (file.open(statsFile) && !stats.load(file.data()))
+            cerr << YELLOW << "[WARN] Ignoring invalid rule stats: " << statsFile << RESET << endl;
+    }
+    if (store != nullptr)
+        stats.sample(*store);
+    order_rules(table, stats, store);
+    if (!statsFile.empty() && store != nullptr && !stats.save(statsFile))
+        cerr << YELLOW << "[WARN] Cannot write rule stats: " << statsFile << RESET << endl;
+}
+
+/**
+ * @brief Classifies records while they are parsed (streaming mode)
+ * @param items Contents of the items file
+ * @param classes Class rules, parsed beforehand
+ * @param errors Sink collecting parsing errors
+ * @param threads Number of parser threads (0 = hardware concurrency)
+ * @param statsFile Rule statistics from earlier runs ("" = none)
+ * @param result Receives the classification result
+ * @return Number of successfully parsed records
+ *
+ * Each record is matched against all classes right after it is parsed
+ * (each distinct rule at most once, see RuleTable) and then discarded; only the per-class lists of matching names are
+ * kept (one set per parser chunk, concatenated in input order), so
+ * memory no longer grows with the size of the items file. The result
+ * is identical to parseRecords() followed by classify(). Records are
+ * not kept for sampling, so the rule order only uses the statistics
+ * of earlier runs.
+ *
+ * Complexity: CCN = 4, NLOC = 23
+ */
+size_t classifyStreaming(string_view items, const vector<ClassRule>& classes, ErrorSink& errors,
+    unsigned threads, const string& statsFile, map<string, vector<string>>& result) {
+    // Per-chunk, per-class lists of matching record names
+    using ClassMatches = vector<vector<string>>;
+    vector<ClassMatches> parts(record_chunk_count(items, threads), ClassMatches(classes.size()));
+    vector<RuleMemo> memos(parts.size());
+    RuleTable table(classes);
+    orderRules(table, nullptr, statsFile);
+
+    vector<string_view> rejected;
+    size_t count = stream_records(items, errors, rejected, threads,
+        [&](size_t chunk, Record& rec) { classify_record(rec, table, parts[chunk], memos[chunk]); });
+
+    for (string_view clean : rejected)
+        cerr << YELLOW << "[WARN] Invalid record format: " << clean << RESET << endl;
+
+    // Concatenate chunk results per class, in input order
+    ClassMatches& matches = parts[0];
+    for (size_t p = 1; p < parts.size(); p++)
+        for (size_t i = 0; i < classes.size(); i++)
+            matches[i].insert(matches[i].end(), make_move_iterator(parts[p][i].begin()),
+                make_move_iterator(parts[p][i].end()));
+
+    result = collect_class_matches(classes, matches);
+    return count;
+}
 
-        classes.push_back(cr);
+/**
+ * @brief Parses classification rules from the rules file contents
+ * @param rules Contents of the rules file
+ * @param classes Vector to store successfully parsed class rules
+ * @param errors Sink collecting parsing errors
+ * @param cacheFile Compiled ruleset cache ("" = parse without cache)
+ * @return true if the classes came from the cache (already validated)
+ *
+ * A cache built from the same rules text is memory-mapped and restored
+ * instead of parsing; otherwise the rules are parsed and, if they pass
+ * validation, the cache is rewritten for the next run. Warnings about
+ * rejected lines are printed either way.
+ *
+ * Complexity: CCN = 6, NLOC = 24
+ */
+bool parseRules(string_view rules, vector<ClassRule>& classes, ErrorSink& errors,
+    const string& cacheFile) {
+    vector<RuleDiagnostic> rejected;
+    bool cached = false;
+
+    if (!cacheFile.empty()) {
+        InputFile cache;
+        cached = cache.open(cacheFile) && load_rule_cache(cache.data(), rules, classes, errors, rejected);
+    }
+    if (cached) {
+        cout << YELLOW << "[INFO] Rules loaded from cache: " << cacheFile << RESET << endl;
     }
+    else {
+        parse_rules(rules, classes, errors, rejected);
+        if (!cacheFile.empty() && validate_classes(classes).isCorrect &&
+            !write_rule_cache(cacheFile, rules, classes, rejected))
+            cerr << YELLOW << "[WARN] Cannot write rules cache: " << cacheFile << RESET << endl;
+    }
+
+    // Report invalid lines; processing of the remaining rules continued
+    for (const auto& d : rejected)
+        cerr << YELLOW << "[WARN] Invalid rule format (line " << d.line << ", column " << d.column
+            << ", " << d.code << "): " << d.text << RESET << endl;
+    return cached;
 }
 
 /**
  * @brief Displays parsing errors to the user
- * @param errors Set containing all accumulated errors
+ * @param errors Sink containing all accumulated errors
  *
- * Complexity: CCN = 2, NLOC = 19
+ * Prints the exact number of errors of each code followed by the
+ * locations of the first ones (file:line[:column]).
+ *
+ * Complexity: CCN = 6, NLOC = 30
  */
-void displayErrors(set<Error>& errors) {
+void displayErrors(const ErrorSink& errors) {
     if (errors.empty()) return;
 
     cout << RED << "\n[WARN] Some records or rules contain errors:\n" << RESET;
     cout << CYAN << "------------------------------------------------------------\n";
-    cout << "Code                  | Source\n";
+    cout << "Code                  | Count    | Source\n";
     cout << "------------------------------------------------------------" << RESET << endl;
 
-    // Display each error
-    for (const auto& e : errors) {
-        Error temp = e; // Copy needed because codeToString is not const
-        string codeStr = temp.codeToString(e.code);
+    // Display each error code with its count and first locations
+    Error temp; // Needed because codeToString is not const
+    for (size_t c = 0; c < ERROR_CODE_COUNT; c++) {
+        ErrorCode code = static_cast<ErrorCode>(c);
+        if (errors.count(code) == 0) continue;
+
+        string codeStr = temp.codeToString(code);
+        string countStr = to_string(errors.count(code));
+        const char* source = "";
+        for (const auto& e : errors.examples())
+            if (e.code == code) { source = e.source; break; }
         cout << codeStr
             << string(22 - min<size_t>(codeStr.length(), 22), ' ')
-            << " | " << e.source << endl;
+            << " | " << countStr << string(8 - min<size_t>(countStr.length(), 8), ' ')
+            << " | " << source << endl;
+
+        for (const auto& e : errors.examples()) {
+            if (e.code != code) continue;
+            cout << "    at " << e.file << ":" << e.line;
+            if (e.column > 0) cout << ":" << e.column;
+            cout << endl;
+        }
     }
 
     cout << CYAN << "------------------------------------------------------------" << RESET << endl;
-    cout << YELLOW << errors.size() << " error(s) detected. "
+    cout << YELLOW << errors.total() << " error(s) detected. "
         << "Output will include only valid items/rules.\n" << RESET;
 }
 
 /**
  * @brief Validates parsed data before classification
- * @param records Vector of parsed records
+ * @param recCheck Result of validating the records
  * @param classes Vector of parsed class rules
+ * @param classesValidated true if the classes came from a rules cache,
+ *                         which only holds validated rulesets
  * @return true if data is valid, false otherwise
  *
- * Complexity: CCN = 3, NLOC = 12
+ * Complexity: CCN = 4, NLOC = 13
  */
-bool validateData(const vector<Record>& records, const vector<ClassRule>& classes) {
+bool validateData(const DataCheckResult& recCheck, const vector<ClassRule>& classes,
+    bool classesValidated) {
     // Validate records
-    DataCheckResult recCheck = validate_records(records);
     if (!recCheck.isCorrect) {
         cerr << RED << "[ERROR] " << recCheck.reason << RESET << endl;
         return false;
     }
 
     // Validate class rules
-    DataCheckResult clsCheck = validate_classes(classes);
+    DataCheckResult clsCheck = classesValidated ? DataCheckResult{ true, "" } : validate_classes(classes);
     if (!clsCheck.isCorrect) {
         cerr << RED << "[ERROR] " << clsCheck.reason << RESET << endl;
         return false;
@@ -246,6 +585,46 @@ bool writeResults(const string& outputFile, const vector<ClassRule>& classes,
     return true;
 }
 
+/**
+ * @brief Parses the items file and writes it as a binary snapshot
+ * @param options Command line settings (itemsFile, compileItems, threads)
+ * @return Process exit code
+ *
+ * The snapshot can be passed instead of the items file on later runs;
+ * it is memory-mapped and classified without parsing.
+ *
+ * Complexity: CCN = 4, NLOC = 22
+ */
+int compileItems(const ProgramOptions& options) {
+    InputFile items;
+    if (!items.open(options.itemsFile)) {
+        cerr << RED << "[ERROR] Cannot open file: " << options.itemsFile << RESET << endl;
+        return 1;
+    }
+    cout << YELLOW << "[INFO] Reading items from: " << options.itemsFile << RESET << endl;
+
+    ErrorSink errors(options.errorExamples);
+    RecordArena arena;
+    vector<Record> records;
+    errors.setFile(options.itemsFile.c_str());
+    parseRecords(items.data(), records, errors, options.threads, arena);
+    displayErrors(errors);
+
+    DataCheckResult recCheck = validate_records(records);
+    if (!recCheck.isCorrect) {
+        cerr << RED << "[ERROR] " << recCheck.reason << RESET << endl;
+        return 1;
+    }
+
+    if (!write_record_snapshot(options.compileItems, records)) {
+        cerr << RED << "[ERROR] Cannot create file: " << options.compileItems << RESET << endl;
+        return 1;
+    }
+    cout << GREEN << "[OK] " << records.size() << " record(s) written to snapshot: "
+        << options.compileItems << RESET << endl;
+    return 0;
+}
+
 // ============================================================================
 // Main Function (Refactored)
 // Original CCN: 20 → Improved CCN: 8
@@ -258,41 +637,110 @@ int main(int argc, char* argv[]) {
     cout << "   Items + Rules --> Output\n";
     cout << "=====================================" << RESET << "\n";
 
-    // Step 1: Validate command line arguments
-    if (!validateCommandLineArgs(argc, argv)) {
+    // Step 1-2: Validate and parse command line arguments
+    ProgramOptions options;
+    if (!parseCommandLineArgs(argc, argv, options)) {
         return 1;
     }
-
-    // Step 2: Parse command line arguments
-    string itemsFile = argv[1];
-    string rulesFile = argv[2];
-    string outputFile = (argc >= 4) ? argv[3] : "output.txt";
+    const string& outputFile = options.outputFile;
+    if (!options.compileItems.empty()) {
+        return compileItems(options);
+    }
 
     // Step 3: Open input files
-    ifstream items, rules;
-    if (!openInputFiles(itemsFile, rulesFile, items, rules)) {
+    InputFile items, rules;
+    if (!openInputFiles(options.itemsFile, options.rulesFile, items, rules)) {
         return 1;
     }
 
-    // Step 4: Parse input data
-    set<Error> errors;
+    // Step 4: Parse input data (classifying on the fly in streaming mode)
+    ErrorSink errors(options.errorExamples);
+    RecordArena arena;                 // Declared first: outlives the records
     vector<Record> records;
     vector<ClassRule> classes;
-
-    parseRecords(items, records, errors);
-    parseRules(rules, classes, errors);
+    map<string, vector<string>> result;
+    size_t streamedRecords = 0;
+    RecordSnapshot snapshot;
+    bool rulesCached = false;
+    bool fromSnapshot = is_record_snapshot(items.data());
+
+    if (fromSnapshot) {
+        // Compiled items: nothing to parse, records are read in place
+        if (!snapshot.load(items.data())) {
+            cerr << RED << "[ERROR] Cannot load snapshot " << options.itemsFile << ": "
+                << snapshot.error() << RESET << endl;
+            return 1;
+        }
+        cout << YELLOW << "[INFO] Items snapshot: " << snapshot.size() << " record(s)" << RESET << endl;
+        if (options.stream || !options.incremental.empty())
+            cerr << YELLOW << "[WARN] --stream and --incremental have no effect on compiled items" << RESET << endl;
+        errors.setFile(options.rulesFile.c_str());
+        rulesCached = parseRules(rules.data(), classes, errors, options.rulesCache);
+    }
+    else if (options.stream) {
+        // Rules are needed first: records are classified as they are parsed
+        errors.setFile(options.rulesFile.c_str());
+        rulesCached = parseRules(rules.data(), classes, errors, options.rulesCache);
+        cout << CYAN << "[INFO] Running classification (streaming)..." << RESET << endl;
+        errors.setFile(options.itemsFile.c_str());
+        streamedRecords = classifyStreaming(items.data(), classes, errors, options.threads,
+            options.ruleStats, result);
+    }
+    else {
+        errors.setFile(options.itemsFile.c_str());
+        if (options.incremental.empty())
+            parseRecords(items.data(), records, errors, options.threads, arena);
+        else
+            parseRecordsIncremental(items.data(), records, errors, options.incremental, options.threads, arena);
+        errors.setFile(options.rulesFile.c_str());
+        rulesCached = parseRules(rules.data(), classes, errors, options.rulesCache);
+    }
 
     // Step 5: Display any parsing errors
     displayErrors(errors);
 
-    // Step 6: Validate parsed data
-    if (!validateData(records, classes)) {
+    // Step 6: Validate parsed data. Streamed records were discarded and
+    // snapshots hold records that were validated when compiled; the
+    // parser only produces named records with unique properties, so
+    // their count is all that is left to check.
+    DataCheckResult recCheck = fromSnapshot ? validate_record_count(snapshot.size())
+        : options.stream ? validate_record_count(streamedRecords)
+        : validate_records(records);
+    if (!validateData(recCheck, classes, rulesCached)) {
         return 1;
     }
 
     // Step 7: Perform classification
-    cout << CYAN << "[INFO] Running classification..." << RESET << endl;
-    auto result = classify(records, classes);
+    if (fromSnapshot || !options.stream) {
+        // Records are classified column-wise, with every engine and
+        // option, whether they were parsed or come from a snapshot; the
+        // record objects are no longer needed once the store holds a
+        // copy, and their memory goes back in a few blocks
+        const ValueStorage storage = options.packValues ? ValueStorage::PACKED : ValueStorage::PLAIN;
+        RecordStore store = fromSnapshot ? RecordStore(snapshot, storage) : RecordStore(records, storage);
+        vector<Record>().swap(records);
+        arena.release();
+        if (options.packValues)
+            cout << YELLOW << "[INFO] Packed values: " << store.valueBytes() << " byte(s), presence and offsets: "
+                << store.indexBytes() << " byte(s)" << RESET << endl;
+        cout << CYAN << "[INFO] Running classification..." << RESET << endl;
+        ThreadPool pool(options.threads);
+        if (options.engine == "scan") {
+            RuleTable table(classes);
+            cout << YELLOW << "[INFO] Rules: " << table.ruleCount() << " distinct of "
+                << table.instanceCount() << RESET << endl;
+            orderRules(table, &store, options.ruleStats);
+            ClassifyTiling tiling = tune_tiling(store, table, cpu_features().l2Cache, options.tiling, pool.size());
+            cout << YELLOW << "[INFO] Tiles: " << tiling.records << " record(s) x "
+                << tiling.classes << " class(es), " << pool.size() << " thread(s)" << RESET << endl;
+            result = classify(store, table, classes, pool, tiling);
+        }
+        else {
+            InvertedIndex index(store, classes);
+            result = options.engine == "index" ? classify(store, index, classes, pool)
+                : classify_bitmaps(store, index, classes, pool);
+        }
+    }
 
     // Step 8: Write results to output file
     if (!writeResults(outputFile, classes, result)) {